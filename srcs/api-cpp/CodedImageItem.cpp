@@ -346,13 +346,22 @@ HEIF::ErrorCode CodedImageItem::load(HEIF::Reader* aReader, const HEIF::ImageId&
 HEIF::ErrorCode CodedImageItem::save(HEIF::Writer* aWriter)
 {
     HEIF::ErrorCode error = HEIF::ErrorCode::OK;
+    HEIF::Data fr;
+    HEIF::MediaDataId mediaDataId;
     if (mBuffer == nullptr)
     {
-        // TODO: actual error is NO_MEDIA
-        return HEIF::ErrorCode::BUFFER_SIZE_TOO_SMALL;
+        // Data not loaded, a pass-through save copies it as stored in the loaded file.
+        error = getHeif()->readPassThroughData(this, mBufferSize, fr);
+        if (HEIF::ErrorCode::NOT_APPLICABLE == error)
+        {
+            // TODO: actual error is NO_MEDIA
+            return HEIF::ErrorCode::BUFFER_SIZE_TOO_SMALL;
+        }
+        if (HEIF::ErrorCode::OK != error)
+        {
+            return error;
+        }
     }
-    HEIF::Data fr;
-    HEIF::MediaDataId mediaDataId;
     if (mConfig)
     {
         if (mConfig->getId() == Heif::InvalidDecoderConfig)
@@ -379,12 +388,15 @@ HEIF::ErrorCode CodedImageItem::save(HEIF::Writer* aWriter)
     std::uint64_t size = 0;
     std::uint8_t* data = nullptr;
 
-    if (!getBitstream(data, size))
+    if (mBuffer != nullptr)
     {
-        return HEIF::ErrorCode::INVALID_MEDIA_FORMAT;
+        if (!getBitstream(data, size))
+        {
+            return HEIF::ErrorCode::INVALID_MEDIA_FORMAT;
+        }
+        fr.size = size;
+        fr.data = data;
     }
-    fr.size        = size;
-    fr.data        = data;
     fr.mediaFormat = mFormat;
 
     if (fr.data == nullptr)
@@ -396,7 +408,7 @@ HEIF::ErrorCode CodedImageItem::save(HEIF::Writer* aWriter)
     error = aWriter->feedMediaData(fr, mediaDataId);
 
     // free temporary data.
-    delete[] fr.data;
+    delete[] data;
 
     if (HEIF::ErrorCode::OK != error)
     {
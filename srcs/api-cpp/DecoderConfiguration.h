@@ -16,7 +16,7 @@
 
 namespace HEIFPP
 {
-    class DecoderConfig
+    class DecoderConfig : public PooledObject
     {
         friend class Sample;
         friend class Heif;
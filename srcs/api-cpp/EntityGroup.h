@@ -15,7 +15,7 @@
 
 namespace HEIFPP
 {
-    class EntityGroup
+    class EntityGroup : public PooledObject
     {
         friend class Heif;
 
@@ -48,17 +48,29 @@ HEIF::ErrorCode ExifItem::load(HEIF::Reader* aReader, const HEIF::ImageId& aId)
 }
 HEIF::ErrorCode ExifItem::save(HEIF::Writer* aWriter)
 {
+    HEIF::Data fr;
     if (mBuffer == nullptr)
     {
-        // TODO: actual error is NO_MEDIA
-        return HEIF::ErrorCode::BUFFER_SIZE_TOO_SMALL;
+        // Data not loaded, a pass-through save copies it as stored in the loaded file.
+        HEIF::ErrorCode error = getHeif()->readPassThroughData(this, mBufferSize, fr);
+        if (HEIF::ErrorCode::NOT_APPLICABLE == error)
+        {
+            // TODO: actual error is NO_MEDIA
+            return HEIF::ErrorCode::BUFFER_SIZE_TOO_SMALL;
+        }
+        if (HEIF::ErrorCode::OK != error)
+        {
+            return error;
+        }
+    }
+    else
+    {
+        fr.size = mBufferSize;
+        fr.data = mBuffer;
     }
 
     HEIF::MediaDataId mediaDataId;
-    HEIF::Data fr;
     fr.mediaFormat     = HEIF::MediaFormat::EXIF;
-    fr.size            = mBufferSize;
-    fr.data            = mBuffer;
     fr.decoderConfigId = 0;
 
     HEIF::ErrorCode error = aWriter->feedMediaData(fr, mediaDataId);
@@ -14,6 +14,8 @@
 
 #include <cstring>
 
+#include "nalutil.hpp"
+
 using namespace HEIFPP;
 
 /*
@@ -121,17 +123,16 @@ bool NAL_State::parse_byte_stream(const std::uint8_t*& nal_unit, std::uint64_t&
     - A subsequent byte-aligned three-byte sequence equal to 0x000001,
     - The end of the byte stream, as determined by unspecified means.
     */
-    const std::uint8_t* src  = mData;
-    std::uint64_t bytes_left = mLength;
-    while (bytes_left)
+    std::uint64_t nal_end = 0;
+    while ((nal_end = findZeroBytePair(mData, mLength, nal_end)) < mLength)
     {
-        if ((bytes_left >= 3) && ((src[0] == 0) && (src[1] == 0) && ((src[2] == 0) || (src[2] == 1))))
+        if ((nal_end + 2 < mLength) && (mData[nal_end + 2] <= 1))
         {
             break;
         }
-        src++;
-        bytes_left--;
+        nal_end++;
     }
+    const std::uint8_t* src = mData + nal_end;
     /* 4. NumBytesInNalUnit bytes are removed from the bitstream and the current position in the byte
     stream is advanced by NumBytesInNalUnit bytes.
     This sequence of bytes is nal_unit( NumBytesInNalUnit ) and is decoded using the NAL unit decoding process.
@@ -193,29 +194,7 @@ bool NAL_State::convertToByteStream(std::uint8_t* aData, std::uint64_t aLength)
 {
     // convert nal stream to byte stream
     // ie. overwrite nal_lengths with byte stream header (use a simple 0 0 0 1 replacement)
-    for (std::uint32_t i = 0; i < aLength;)
-    {
-        if ((aLength - i) < 4)
-        {
-            return false;
-        }
-
-        std::uint32_t len;
-        len = static_cast<std::uint32_t>(aData[i + 0] << 24u);
-        len |= static_cast<std::uint32_t>(aData[i + 1] << 16u);
-        len |= static_cast<std::uint32_t>(aData[i + 2] << 8u);
-        len |= static_cast<std::uint32_t>(aData[i + 3]);
-        if ((aLength - i) < len)
-        {
-            return false;
-        }
-        aData[i + 0] = 0;
-        aData[i + 1] = 0;
-        aData[i + 2] = 0;
-        aData[i + 3] = 1;
-        i += len + 4;
-    }
-    return true;
+    return convertLengthFieldsToStartCodes(aData, aLength);
 }
 
 bool NAL_State::convertFromByteStream(uint8_t* aBuffer,
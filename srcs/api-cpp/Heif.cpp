@@ -56,7 +56,8 @@ const HEIF::MediaDataId Heif::InvalidMediaData(static_cast<std::uint32_t>(0));
 
 
 Heif::Heif()
-    : mFileinfo{}
+    : mFileinfoStorage{}
+    , mFileinfo(&mFileinfoStorage)
     , mMajorBrand()
     , mMinorVersion(0)
     , mCompatibleBrands()
@@ -82,60 +83,55 @@ Heif::~Heif()
 
 void Heif::reset()
 {
+    // Objects are deleted newest first, the links between them are then removed from the ends of the link lists.
     for (; !mAltGroups.empty();)
     {
-        auto it = mAltGroups.begin();
-        delete (*it);
+        delete mAltGroups.back();
     }
     for (; !mGroups.empty();)
     {
-        auto it = mGroups.begin();
-        delete (*it);
+        delete mGroups.back();
     }
     for (; !mTracks.empty();)
     {
-        auto it = mTracks.begin();
-        delete (*it);
+        delete mTracks.back();
     }
     for (; !mSamples.empty();)
     {
-        auto it = mSamples.begin();
-        delete (*it);
+        delete mSamples.back();
     }
     for (; !mItems.empty();)
     {
-        auto it = mItems.begin();
-        delete (*it);
+        delete mItems.back();
     }
     for (; !mProperties.empty();)
     {
-        auto it = mProperties.begin();
-        delete (*it);
+        delete mProperties.back();
     }
     for (; !mDecoderConfigs.empty();)
     {
-        auto it = mDecoderConfigs.begin();
-        delete (*it);
+        delete mDecoderConfigs.back();
     }
     mCompatibleBrands.clear();
-    mMajorBrand  = HEIF::FourCC();
-    mPrimaryItem = nullptr;
-    mFileinfo    = HEIF::FileInformation();
-    mMatrix[0]   = 0x10000;
-    mMatrix[1]   = 0;
-    mMatrix[2]   = 0;
-    mMatrix[3]   = 0;
-    mMatrix[4]   = 0x10000;
-    mMatrix[5]   = 0;
-    mMatrix[6]   = 0;
-    mMatrix[7]   = 0;
-    mMatrix[8]   = 0x40000000;
+    mMajorBrand      = HEIF::FourCC();
+    mPrimaryItem     = nullptr;
+    mFileinfoStorage = HEIF::FileInformation();
+    mFileinfo        = &mFileinfoStorage;
+    mMatrix[0]       = 0x10000;
+    mMatrix[1]       = 0;
+    mMatrix[2]       = 0;
+    mMatrix[3]       = 0;
+    mMatrix[4]       = 0x10000;
+    mMatrix[5]       = 0;
+    mMatrix[6]       = 0;
+    mMatrix[7]       = 0;
+    mMatrix[8]       = 0x40000000;
 
     if (mReader != nullptr)
     {
-        HEIF::Reader::Destroy(mReader);
-        mReader = nullptr;
+        destroyReader();
     }
+    mObjectPool.release();
 }
 
 /** Custom user data can be bound to objects. */
@@ -149,17 +145,17 @@ const void* Heif::getContext() const
     return mContext;
 }
 
-Result Heif::save(const char* aFilename)
+Result Heif::save(const char* aFilename, SaveMode aSaveMode)
 {
-    return save(aFilename, nullptr);
+    return save(aFilename, nullptr, aSaveMode);
 }
 
-Result Heif::save(HEIF::OutputStreamInterface* aStream)
+Result Heif::save(HEIF::OutputStreamInterface* aStream, SaveMode aSaveMode)
 {
-    return save(nullptr, aStream);
+    return save(nullptr, aStream, aSaveMode);
 }
 
-Result Heif::save(const char* aFileName, HEIF::OutputStreamInterface* aStream)
+Result Heif::save(const char* aFileName, HEIF::OutputStreamInterface* aStream, SaveMode aSaveMode)
 {
     if (mMajorBrand == HEIF::FourCC())
     {
@@ -180,7 +176,36 @@ Result Heif::save(const char* aFileName, HEIF::OutputStreamInterface* aStream)
         }
     }
 
-    if (mReader != nullptr)
+    // Samples not accessed after a LOAD_ON_DEMAND load are constructed now, while their ids in the loaded file are
+    // still known.
+    for (auto* track : mTracks)
+    {
+        const HEIF::ErrorCode error = track->loadSamples();
+        if (HEIF::ErrorCode::OK != error)
+        {
+            return convertErrorCode(error);
+        }
+    }
+
+    const bool passThrough = (mReader != nullptr) && (aSaveMode == SaveMode::SAVE_PASS_THROUGH);
+    if (passThrough)
+    {
+        // Remember the ids in the loaded file, as saving replaces them with the ids of the new file. Data not loaded
+        // is then read by the items and samples themselves right before it is fed to the writer. Ids kept from a
+        // failed save are not overwritten, as they are still the ones in the loaded file.
+        for (auto* item : mItems)
+        {
+            mPassThroughItems.emplace(item, item->getId());
+        }
+        for (auto* sample : mSamples)
+        {
+            if (sample->getTrack() != nullptr)
+            {
+                mPassThroughSamples.emplace(sample, std::make_pair(sample->getTrack()->getId(), sample->getId()));
+            }
+        }
+    }
+    else if (mReader != nullptr)
     {
         if (mPreLoadMode != PreloadMode::LOAD_ALL_DATA)
         {
@@ -212,8 +237,7 @@ Result Heif::save(const char* aFileName, HEIF::OutputStreamInterface* aStream)
                 }
             }
         }
-        HEIF::Reader::Destroy(mReader);
-        mReader = nullptr;
+        destroyReader();
     }
 
     HEIF::ErrorCode error = HEIF::ErrorCode::OK;
@@ -355,15 +379,56 @@ Result Heif::save(const char* aFileName, HEIF::OutputStreamInterface* aStream)
         }
     }
     HEIF::Writer::Destroy(writer);
+
+    if (passThrough)
+    {
+        std::vector<std::uint8_t>().swap(mPassThroughBuffer);
+        // After a failed save the data not loaded is still needed, so the reader is kept for another attempt.
+        if (HEIF::ErrorCode::OK == error)
+        {
+            mPassThroughItems.clear();
+            mPassThroughSamples.clear();
+            destroyReader();
+        }
+    }
     return convertErrorCode(error);
 }
+
+HEIF::ErrorCode Heif::readPassThroughData(const Item* aItem, std::uint64_t aSize, HEIF::Data& aData)
+{
+    const auto source = mPassThroughItems.find(aItem);
+    if (source == mPassThroughItems.end())
+    {
+        return HEIF::ErrorCode::NOT_APPLICABLE;
+    }
+    mPassThroughBuffer.resize(static_cast<size_t>(aSize));
+    HEIF::ErrorCode error = mReader->getItemData(source->second, mPassThroughBuffer.data(), aSize, false);
+    aData.data            = mPassThroughBuffer.data();
+    aData.size            = aSize;
+    return error;
+}
+
+HEIF::ErrorCode Heif::readPassThroughData(const Sample* aSample, std::uint64_t aSize, HEIF::Data& aData)
+{
+    const auto source = mPassThroughSamples.find(aSample);
+    if (source == mPassThroughSamples.end())
+    {
+        return HEIF::ErrorCode::NOT_APPLICABLE;
+    }
+    mPassThroughBuffer.resize(static_cast<size_t>(aSize));
+    HEIF::ErrorCode error =
+        mReader->getItemData(source->second.first, source->second.second, mPassThroughBuffer.data(), aSize, false);
+    aData.data = mPassThroughBuffer.data();
+    aData.size = aSize;
+    return error;
+}
 const HEIF::FileInformation* Heif::getFileInformation() const
 {
-    return &mFileinfo;
+    return mFileinfo;
 }
 const HEIF::ItemInformation* Heif::getItemInformation(const HEIF::ImageId& aItemId) const
 {
-    for (const auto& i : mFileinfo.rootMetaBoxInformation.itemInformations)
+    for (const auto& i : mFileinfo->rootMetaBoxInformation.itemInformations)
     {
         if (i.itemId == aItemId)
         {
@@ -374,7 +439,7 @@ const HEIF::ItemInformation* Heif::getItemInformation(const HEIF::ImageId& aItem
 }
 const HEIF::TrackInformation* Heif::getTrackInformation(const HEIF::SequenceId& aItemId) const
 {
-    for (const auto& i : mFileinfo.trackInformation)
+    for (const auto& i : mFileinfo->trackInformation)
     {
         if (i.trackId == aItemId)
         {
@@ -426,8 +491,7 @@ Result Heif::load(const char* aFilename, HEIF::StreamInterface* aStream, Preload
 
     if (mReader != nullptr)
     {
-        HEIF::Reader::Destroy(mReader);
-        mReader = nullptr;
+        destroyReader();
     }
 
     mReader               = HEIF::Reader::Create();
@@ -448,7 +512,11 @@ Result Heif::load(const char* aFilename, HEIF::StreamInterface* aStream, Preload
     mItemsLoad.clear();
     mTracksLoad.clear();
     mPropertiesLoad.clear();
-    mDecoderConfigsLoad.clear();
+    if (mPreLoadMode != PreloadMode::LOAD_ON_DEMAND)
+    {
+        // samples constructed on demand share the decoder configurations, see Track::loadSample().
+        mDecoderConfigsLoad.clear();
+    }
     mSamplesLoad.clear();
     mGroupsLoad.clear();
     mAltGroupsLoad.clear();
@@ -460,13 +528,24 @@ Result Heif::load(const char* aFilename, HEIF::StreamInterface* aStream, Preload
 
     if (mPreLoadMode == PreloadMode::LOAD_ALL_DATA)
     {
-        HEIF::Reader::Destroy(mReader);
-        mReader = nullptr;
+        destroyReader();
     }
 
     return convertErrorCode(error);
 }
 
+void Heif::destroyReader()
+{
+    if (mFileinfo != &mFileinfoStorage)
+    {
+        mFileinfoStorage = *mFileinfo;
+        mFileinfo        = &mFileinfoStorage;
+    }
+    mDecoderConfigsLoad.clear();
+    HEIF::Reader::Destroy(mReader);
+    mReader = nullptr;
+}
+
 HEIF::ErrorCode Heif::load(HEIF::Reader* aReader)
 {
     HEIF::ErrorCode error;
@@ -488,7 +567,7 @@ HEIF::ErrorCode Heif::load(HEIF::Reader* aReader)
                 error = aReader->getFileInformation(mFileinfo);
                 if (HEIF::ErrorCode::OK == error)
                 {
-                    if (mFileinfo.features & HEIF::FileFeatureEnum::HasRootLevelMetaBox)
+                    if (mFileinfo->features & HEIF::FileFeatureEnum::HasRootLevelMetaBox)
                     {
                         HEIF::ImageId prim = InvalidItem;
                         error              = aReader->getPrimaryItem(prim);
@@ -504,7 +583,7 @@ HEIF::ErrorCode Heif::load(HEIF::Reader* aReader)
                             return error;
                         }
 
-                        for (const auto& i : mFileinfo.rootMetaBoxInformation.itemInformations)
+                        for (const auto& i : mFileinfo->rootMetaBoxInformation.itemInformations)
                         {
                             ImageItem* image = constructImageItem(aReader, i.itemId, &i, error);
                             if (HEIF::ErrorCode::OK != error)
@@ -535,9 +614,12 @@ HEIF::ErrorCode Heif::load(HEIF::Reader* aReader)
                             }
                         }
                     }
-                    for (const auto& i : mFileinfo.trackInformation)
+                    for (const auto& i : mFileinfo->trackInformation)
                     {
-                        mSamples.reserve(mSamples.size() + i.sampleProperties.size);
+                        if (mPreLoadMode != PreloadMode::LOAD_ON_DEMAND)
+                        {
+                            mSamples.reserve(mSamples.size() + i.sampleProperties.size);
+                        }
                         constructTrack(aReader, i.trackId, error);
                         if (HEIF::ErrorCode::OK != error)
                         {
@@ -548,7 +630,7 @@ HEIF::ErrorCode Heif::load(HEIF::Reader* aReader)
                     // handle grouping here. and not in track/image/sample.
 
                     // first link items and tracks...
-                    for (const auto& g : mFileinfo.rootMetaBoxInformation.entityGroupings)
+                    for (const auto& g : mFileinfo->rootMetaBoxInformation.entityGroupings)
                     {
                         Track* track = nullptr;
                         Item* item   = nullptr;
@@ -585,7 +667,7 @@ HEIF::ErrorCode Heif::load(HEIF::Reader* aReader)
                     }
 
                     // and now check if tracks are linked with out specifying them in the entitygroupings.
-                    for (const auto& ii : mFileinfo.trackInformation)
+                    for (const auto& ii : mFileinfo->trackInformation)
                     {
                         auto* info = &ii;
                         if (info->alternateGroupId != 0)
@@ -606,11 +688,12 @@ HEIF::ErrorCode Heif::load(HEIF::Reader* aReader)
                     }
 
                     // and finally handle sample groupings (metadata or other..)
-                    for (const auto& ii : mFileinfo.trackInformation)
+                    for (const auto& ii : mFileinfo->trackInformation)
                     {
                         auto* info = &ii;
                         if (mTracksLoad.find(ii.trackId) != mTracksLoad.end())
                         {
+                            Track* track = mTracksLoad[ii.trackId];
                             std::map<std::uint32_t, HEIF::SampleVisualEquivalence> groupIdToEqu;
                             std::map<std::uint32_t, HEIF::SampleToMetadataItem> groupIdToMeta;
 
@@ -629,7 +712,11 @@ HEIF::ErrorCode Heif::load(HEIF::Reader* aReader)
                                     // handle sample to meta specially.
                                     for (const auto& sampleId : at.samples)
                                     {
-                                        Sample* s        = mSamplesLoad[{ii.trackId, sampleId.sampleId}];
+                                        Sample* s = track->loadSampleById(sampleId.sampleId, error);
+                                        if (HEIF::ErrorCode::OK != error)
+                                        {
+                                            return error;
+                                        }
                                         const auto& meta = groupIdToMeta[sampleId.sampleGroupDescriptionIndex];
                                         for (auto metaId : meta.metadataItemIds)
                                         {
@@ -663,7 +750,11 @@ HEIF::ErrorCode Heif::load(HEIF::Reader* aReader)
                                         auto* eg = static_cast<EquivalenceGroup*>(group);
                                         for (const auto& sampleId : at.samples)
                                         {
-                                            Sample* s       = mSamplesLoad[{ii.trackId, sampleId.sampleId}];
+                                            Sample* s = track->loadSampleById(sampleId.sampleId, error);
+                                            if (HEIF::ErrorCode::OK != error)
+                                            {
+                                                return error;
+                                            }
                                             const auto& equ = groupIdToEqu[sampleId.sampleGroupDescriptionIndex];
                                             eg->addSample(s, equ.timeOffset, equ.timescaleMultiplier);
                                         }
@@ -680,21 +771,29 @@ HEIF::ErrorCode Heif::load(HEIF::Reader* aReader)
                                         group = it.first->second;
                                         for (const auto& sampleId : at.samples)
                                         {
-                                            Sample* s = mSamplesLoad[{ii.trackId, sampleId.sampleId}];
+                                            Sample* s = track->loadSampleById(sampleId.sampleId, error);
+                                            if (HEIF::ErrorCode::OK != error)
+                                            {
+                                                return error;
+                                            }
                                             group->addSample(s);
                                         }
                                     }
                                 }
                             }
 
-                            for (const auto& sampleId : info->sampleProperties)
+                            // samples constructed on demand are linked to their decode dependencies by the track.
+                            if (mPreLoadMode != PreloadMode::LOAD_ON_DEMAND)
                             {
-                                Sample* s = mSamplesLoad[{ii.trackId, sampleId.sampleId}];
-                                HEIF::Array<HEIF::SequenceImageId> dependencies;
-                                aReader->getDecodeDependencies(ii.trackId, sampleId.sampleId, dependencies);
-                                for (auto sid : dependencies)
+                                for (const auto& sampleId : info->sampleProperties)
                                 {
-                                    s->addDecodeDependency(mSamplesLoad[{ii.trackId, sid}]);
+                                    Sample* s = mSamplesLoad[{ii.trackId, sampleId.sampleId}];
+                                    HEIF::Array<HEIF::SequenceImageId> dependencies;
+                                    aReader->getDecodeDependencies(ii.trackId, sampleId.sampleId, dependencies);
+                                    for (auto sid : dependencies)
+                                    {
+                                        s->addDecodeDependency(mSamplesLoad[{ii.trackId, sid}]);
+                                    }
                                 }
                             }
                         }
@@ -785,9 +884,9 @@ EntityGroup* Heif::constructGroup(const HEIF::FourCC& aType)
 {
     if (aType == "eqiv")
     {
-        return new EquivalenceGroup(this);
+        return new (mObjectPool) EquivalenceGroup(this);
     }
-    return new EntityGroup(this, aType);
+    return new (mObjectPool) EntityGroup(this, aType);
 }
 
 Sample* Heif::constructSample(HEIF::Reader* aReader,
@@ -798,34 +897,12 @@ Sample* Heif::constructSample(HEIF::Reader* aReader,
     auto it = mSamplesLoad.insert({{aTrack, aInfo.sampleId}, nullptr});
     if (it.second)
     {
-        auto info    = getTrackInformation(aTrack);
-        Sample* item = nullptr;
-
-        if ((info->features & HEIF::TrackFeatureEnum::Feature::IsVideoTrack) ||
-            (info->features & HEIF::TrackFeatureEnum::Feature::IsMasterImageSequence) ||
-            (info->features & HEIF::TrackFeatureEnum::Feature::IsThumbnailImageSequence) ||
-            (info->features & HEIF::TrackFeatureEnum::Feature::IsAuxiliaryImageSequence))
-        {
-            item = new VideoSample(this);
-        }
-        else if (info->features & HEIF::TrackFeatureEnum::Feature::IsAudioTrack)
-        {
-            item = new AudioSample(this);
-        }
-        else
-        {
-            // unknown sample type. ignore.
-        }
+        Sample* item = createSample(aReader, aTrack, aInfo, aErrorCode);
         if (item)
         {
-            item->setId(aInfo.sampleId);
             it.first->second = item;
-            aErrorCode       = item->load(aReader, aTrack, aInfo);
             return item;
         }
-#ifdef FAIL_ON_UNKNOWN_ITEM
-        aErrorCode = HEIF::ErrorCode::MEDIA_PARSING_ERROR;
-#endif
         // invalid state.
         mSamplesLoad.erase({aTrack, aInfo.sampleId});
         return nullptr;
@@ -834,6 +911,41 @@ Sample* Heif::constructSample(HEIF::Reader* aReader,
     return it.first->second;
 }
 
+Sample* Heif::createSample(HEIF::Reader* aReader,
+                           const HEIF::SequenceId& aTrack,
+                           const HEIF::SampleInformation& aInfo,
+                           HEIF::ErrorCode& aErrorCode)
+{
+    auto info    = getTrackInformation(aTrack);
+    Sample* item = nullptr;
+
+    if ((info->features & HEIF::TrackFeatureEnum::Feature::IsVideoTrack) ||
+        (info->features & HEIF::TrackFeatureEnum::Feature::IsMasterImageSequence) ||
+        (info->features & HEIF::TrackFeatureEnum::Feature::IsThumbnailImageSequence) ||
+        (info->features & HEIF::TrackFeatureEnum::Feature::IsAuxiliaryImageSequence))
+    {
+        item = new (mObjectPool) VideoSample(this);
+    }
+    else if (info->features & HEIF::TrackFeatureEnum::Feature::IsAudioTrack)
+    {
+        item = new (mObjectPool) AudioSample(this);
+    }
+    else
+    {
+        // unknown sample type. ignore.
+    }
+    if (item)
+    {
+        item->setId(aInfo.sampleId);
+        aErrorCode = item->load(aReader, aTrack, aInfo);
+        return item;
+    }
+#ifdef FAIL_ON_UNKNOWN_ITEM
+    aErrorCode = HEIF::ErrorCode::MEDIA_PARSING_ERROR;
+#endif
+    return nullptr;
+}
+
 Track* Heif::constructTrack(HEIF::Reader* aReader, const HEIF::SequenceId& aTrackId, HEIF::ErrorCode& aErrorCode)
 {
     auto it = mTracksLoad.insert({aTrackId, nullptr});
@@ -900,28 +1012,28 @@ ImageItem* Heif::constructImageItem(HEIF::Reader* aReader,
         Item* item = nullptr;
         if (type == HEIF::FourCC("avc1"))
         {
-            item = new AVCCodedImageItem(this);
+            item = new (mObjectPool) AVCCodedImageItem(this);
         }
         else if (type == HEIF::FourCC("hvc1"))
         {
-            item = new HEVCCodedImageItem(this);
+            item = new (mObjectPool) HEVCCodedImageItem(this);
         }
         else if (type == HEIF::FourCC("jpeg"))
         {
             // mime image/jpeg handled in separate case
-            item = new JPEGCodedImageItem(this);
+            item = new (mObjectPool) JPEGCodedImageItem(this);
         }
         else if (type == HEIF::FourCC("iden"))
         {
-            item = new IdentityImageItem(this);
+            item = new (mObjectPool) IdentityImageItem(this);
         }
         else if (type == HEIF::FourCC("iovl"))
         {
-            item = new OverlayImageItem(this);
+            item = new (mObjectPool) OverlayImageItem(this);
         }
         else if (type == HEIF::FourCC("grid"))
         {
-            item = new GridImageItem(this);
+            item = new (mObjectPool) GridImageItem(this);
         }
         else if (type == HEIF::FourCC("mime") && aItemInfo)
         {
@@ -931,7 +1043,7 @@ ImageItem* Heif::constructImageItem(HEIF::Reader* aReader,
             {
                 // How bad is this? Should really do MimeItem, but what about compatibility. Special
                 // support in JPEGCodedImageItem maybe required.
-                item = new JPEGCodedImageItem(this);
+                item = new (mObjectPool) JPEGCodedImageItem(this);
             }
             else
             {
@@ -979,7 +1091,7 @@ MetaItem* Heif::constructMetaItem(HEIF::Reader* aReader, const HEIF::ImageId& aI
         Item* item = nullptr;
         if (type == HEIF::FourCC("Exif"))
         {
-            item = new ExifItem(this);
+            item = new (mObjectPool) ExifItem(this);
         }
         else if (type == HEIF::FourCC("mime"))
         {
@@ -988,16 +1100,16 @@ MetaItem* Heif::constructMetaItem(HEIF::Reader* aReader, const HEIF::ImageId& aI
             if (mimetype == "text/xml")
             {
                 // TODO: should actually check the content schema for "urn:mpeg:mpeg7:schema:2001" etcetc.
-                item = new MPEG7Item(this);
+                item = new (mObjectPool) MPEG7Item(this);
             }
             else if (mimetype == "application/rdf+xml")
             {
-                item = new XMPItem(this);
+                item = new (mObjectPool) XMPItem(this);
             }
             else
             {
                 // Creates a generic mime item.
-                item = new MimeItem(this);
+                item = new (mObjectPool) MimeItem(this);
             }
         }
         if (item)
@@ -1038,42 +1150,42 @@ ItemProperty* Heif::constructItemProperty(HEIF::Reader* aReader,
         {
         case HEIF::ItemPropertyType::CLAP:
         {
-            p = new CleanApertureProperty(this);
+            p = new (mObjectPool) CleanApertureProperty(this);
             break;
         }
         case HEIF::ItemPropertyType::IROT:
         {
-            p = new RotateProperty(this);
+            p = new (mObjectPool) RotateProperty(this);
             break;
         }
         case HEIF::ItemPropertyType::IMIR:
         {
-            p = new MirrorProperty(this);
+            p = new (mObjectPool) MirrorProperty(this);
             break;
         }
         case HEIF::ItemPropertyType::PASP:
         {
-            p = new PixelAspectRatioProperty(this);
+            p = new (mObjectPool) PixelAspectRatioProperty(this);
             break;
         }
         case HEIF::ItemPropertyType::COLR:
         {
-            p = new ColourInformationProperty(this);
+            p = new (mObjectPool) ColourInformationProperty(this);
             break;
         }
         case HEIF::ItemPropertyType::PIXI:
         {
-            p = new PixelInformationProperty(this);
+            p = new (mObjectPool) PixelInformationProperty(this);
             break;
         }
         case HEIF::ItemPropertyType::RLOC:
         {
-            p = new RelativeLocationProperty(this);
+            p = new (mObjectPool) RelativeLocationProperty(this);
             break;
         }
         case HEIF::ItemPropertyType::AUXC:
         {
-            p = new AuxiliaryProperty(this);
+            p = new (mObjectPool) AuxiliaryProperty(this);
             break;
         }
         case HEIF::ItemPropertyType::ISPE:
@@ -1081,7 +1193,7 @@ ItemProperty* Heif::constructItemProperty(HEIF::Reader* aReader,
             // not accessible directly, use HEIF::Reader::getWidth/HEIF::Reader::getHeight
 #if ISPE_AS_RAW_PROPERTY
             // so construct as RawProperty..
-            p = new RawProperty(this);
+            p = new (mObjectPool) RawProperty(this);
 #else
             // ignore the property
             aErrorCode = HEIF::ErrorCode::OK;
@@ -1097,7 +1209,7 @@ ItemProperty* Heif::constructItemProperty(HEIF::Reader* aReader,
             // so construct as raw..
 #if DECODER_CONFIG_AS_RAW_PROPERTY
             // so construct as RawProperty..
-            p = new RawProperty(this);
+            p = new (mObjectPool) RawProperty(this);
 #else
             // ignore the property
             aErrorCode = HEIF::ErrorCode::OK;
@@ -1114,7 +1226,7 @@ ItemProperty* Heif::constructItemProperty(HEIF::Reader* aReader,
         default:
         {
             // construct as raw..
-            p = new RawProperty(this);
+            p = new (mObjectPool) RawProperty(this);
             break;
         }
         }
@@ -1469,22 +1581,22 @@ DecoderConfig* Heif::constructDecoderConfig(HEIF::Reader* aReader,
         {
         case HEIF::MediaFormat::AVC:
         {
-            config = new AVCDecoderConfiguration(this, aType);
+            config = new (mObjectPool) AVCDecoderConfiguration(this, aType);
             break;
         }
         case HEIF::MediaFormat::HEVC:
         {
-            config = new HEVCDecoderConfiguration(this, aType);
+            config = new (mObjectPool) HEVCDecoderConfiguration(this, aType);
             break;
         }
         case HEIF::MediaFormat::AAC:
         {
-            config = new AACDecoderConfiguration(this, aType);
+            config = new (mObjectPool) AACDecoderConfiguration(this, aType);
             break;
         }
         case HEIF::MediaFormat::JPEG:
         {
-            config = new JPEGDecoderConfiguration(this, aType);
+            config = new (mObjectPool) JPEGDecoderConfiguration(this, aType);
             break;
         }
         default:
@@ -1549,6 +1661,17 @@ void Heif::removeDecoderConfig(DecoderConfig* aDecoderConfig)
         // Tried to remove a non added DecoderConfiguration
         HEIF_ASSERT(false);
     }
+    for (auto it = mDecoderConfigsLoad.begin(); it != mDecoderConfigsLoad.end();)
+    {
+        if (it->second == aDecoderConfig)
+        {
+            it = mDecoderConfigsLoad.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
 }
 
 std::uint32_t Heif::getTrackCount() const
@@ -13,6 +13,7 @@
 #ifndef HEIF_H
 #define HEIF_H
 
+#include <ObjectPool.h>
 #include <heifcommondatatypes.h>
 #include <heifreaderdatatypes.h>
 #include <heifwriterdatatypes.h>
@@ -89,7 +90,16 @@ namespace HEIFPP
             LOAD_ALL_DATA = 0,  // Loads all item data to memory.
             LOAD_PREVIEW_DATA,  // Load preview data to memory (thumbnail/meta). Fast to preview file, but actual item
                                 // data loaded on demand.
-            LOAD_ON_DEMAND      // Preload none of the sample/image/metadata to memory. Fastest to load.
+            LOAD_ON_DEMAND      // Preload none of the sample/image/metadata to memory. Fastest to load. Track samples
+                                // are constructed on first access, e.g. with Track::getSample().
+        };
+
+        enum SaveMode
+        {
+            SAVE_ALL_DATA = 0,  // Loads all item and sample data to memory before saving. Container stays usable.
+            SAVE_PASS_THROUGH   // Copies data not yet loaded from the loaded file one item/sample at a time. Memory use
+                                // does not depend on file size. Output must not be the loaded file, and data not
+                                // loaded before a successful save is no longer available after it.
         };
 
         /** Create an empty instance
@@ -120,13 +130,15 @@ namespace HEIFPP
 
         /** Save content to file.
          *  @param [in] fileName Name of the saved file.
+         *  @param [in] saveMode Control how data not yet loaded is saved, see SaveMode.
          *  @return Result: Possible error code */
-        Result save(const char* fileName);
+        Result save(const char* fileName, SaveMode saveMode = SAVE_ALL_DATA);
 
         /** Save content to stream.
-         *  @param [in] stream Stream to save the file to.
+         *  @param [in] stream   Stream to save the file to.
+         *  @param [in] saveMode Control how data not yet loaded is saved, see SaveMode.
          *  @return Result: Possible error code */
-        Result save(HEIF::OutputStreamInterface* stream);
+        Result save(HEIF::OutputStreamInterface* stream, SaveMode saveMode = SAVE_ALL_DATA);
 
         /** Clears the container to initial state. */
         void reset();
@@ -339,6 +351,12 @@ namespace HEIFPP
                                 const HEIF::SequenceId& aTrack,
                                 const HEIF::SampleInformation& aInfo,
                                 HEIF::ErrorCode& aErrorCode);
+        /** Creates and loads a sample without the load time bookkeeping of constructSample(). Used when samples are
+         *  constructed on demand, see Track::loadSample(). */
+        Sample* createSample(HEIF::Reader* aReader,
+                             const HEIF::SequenceId& aTrack,
+                             const HEIF::SampleInformation& aInfo,
+                             HEIF::ErrorCode& aErrorCode);
         /** aItemInfo may be null to indicate there is no associated ItemInfo object */
         ImageItem* constructImageItem(HEIF::Reader* aReader,
                                       const HEIF::ImageId& aItemId,
@@ -378,8 +396,18 @@ namespace HEIFPP
         void addAlternativeTrackGroup(AlternativeTrackGroup* aGroup);
         HEIF::Reader* getReaderInstance();
 
+        /** Reads data of an item or sample from the loaded file during a SAVE_PASS_THROUGH save.
+         *  @param [in]  aItem / aSample Item or sample whose data has not been loaded.
+         *  @param [in]  aSize           Size of the data in the loaded file.
+         *  @param [out] aData           Data as stored in the file, valid until the next call.
+         *  @return ErrorCode: OK, NOT_APPLICABLE if not saving in pass-through mode or the object was not loaded from
+         *  the file, or a reader error. */
+        HEIF::ErrorCode readPassThroughData(const Item* aItem, std::uint64_t aSize, HEIF::Data& aData);
+        HEIF::ErrorCode readPassThroughData(const Sample* aSample, std::uint64_t aSize, HEIF::Data& aData);
+
     protected:
-        HEIF::FileInformation mFileinfo;
+        HEIF::FileInformation mFileinfoStorage;  ///< Copy of the file information once the reader is destroyed.
+        const HEIF::FileInformation* mFileinfo;  ///< File information of mReader, or mFileinfoStorage.
         HEIF::FourCC mMajorBrand;
         std::uint32_t mMinorVersion;
         std::vector<HEIF::FourCC> mCompatibleBrands;
@@ -409,10 +437,18 @@ namespace HEIFPP
 
     private:
         Result load(const char* aFilename, HEIF::StreamInterface* aStream, PreloadMode loadMode);
-        Result save(const char* aFilename, HEIF::OutputStreamInterface* aStream);
+        Result save(const char* aFilename, HEIF::OutputStreamInterface* aStream, SaveMode aSaveMode);
         HEIF::ErrorCode load(HEIF::Reader* aReader);
+        /** Destroys mReader. File information viewed from the reader is copied to mFileinfoStorage first. */
+        void destroyReader();
         const void* mContext;
         HEIF::Reader* mReader;
+        ObjectPool mObjectPool;  ///< Items, samples, properties, decoder configurations and groups created by Heif.
+
+        // Ids in the loaded file, valid during a SAVE_PASS_THROUGH save.
+        std::map<const Item*, HEIF::ImageId> mPassThroughItems;
+        std::map<const Sample*, std::pair<HEIF::SequenceId, HEIF::SequenceImageId>> mPassThroughSamples;
+        std::vector<std::uint8_t> mPassThroughBuffer;
 
     private:
         Heif& operator=(const Heif&) = delete;
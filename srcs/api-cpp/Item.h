@@ -17,7 +17,7 @@
 namespace HEIFPP
 {
     /** @brief Item abstraction*/
-    class Item
+    class Item : public PooledObject
     {
         friend class EntityGroup;
         friend class Heif;
@@ -16,7 +16,7 @@
 
 namespace HEIFPP
 {
-    class ItemProperty
+    class ItemProperty : public PooledObject
     {
         friend class Item;
         friend class Heif;
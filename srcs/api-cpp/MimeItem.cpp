@@ -68,15 +68,29 @@ HEIF::ErrorCode MimeItem::load(HEIF::Reader* aReader, const HEIF::ImageId& aId)
 }
 HEIF::ErrorCode MimeItem::save(HEIF::Writer* aWriter)
 {
+    HEIF::ErrorCode error = HEIF::ErrorCode::OK;
+    HEIF::Data fr;
     if (mBuffer == nullptr)
     {
-        // TODO: actual error is NO_MEDIA
-        return HEIF::ErrorCode::BUFFER_SIZE_TOO_SMALL;
+        // Data not loaded, a pass-through save copies it as stored in the loaded file.
+        error = getHeif()->readPassThroughData(this, mBufferSize, fr);
+        if (HEIF::ErrorCode::NOT_APPLICABLE == error)
+        {
+            // TODO: actual error is NO_MEDIA
+            return HEIF::ErrorCode::BUFFER_SIZE_TOO_SMALL;
+        }
+        if (HEIF::ErrorCode::OK != error)
+        {
+            return error;
+        }
+    }
+    else
+    {
+        fr.size = mBufferSize;
+        fr.data = mBuffer;
     }
-    HEIF::ErrorCode error = HEIF::ErrorCode::OK;
 
     HEIF::MediaDataId mediaDataId;
-    HEIF::Data fr;
     if (Item::getContentType() == "")
     {
         // TODO: "content type not set"
@@ -84,8 +98,6 @@ HEIF::ErrorCode MimeItem::save(HEIF::Writer* aWriter)
     }
     // TODO: this should not be needed. actual contenttype is written Item::save
     fr.mediaFormat     = HEIF::MediaFormat::MPEG7;
-    fr.size            = mBufferSize;
-    fr.data            = mBuffer;
     fr.decoderConfigId = 0;
 
     // TODO: re-use of data?
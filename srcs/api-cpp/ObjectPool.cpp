@@ -0,0 +1,164 @@
+/*
+ * This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2025 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved. Copying, including reproducing, storing, adapting or translating, any or all
+ * of this material requires the prior written consent of Nokia.
+ */
+
+#include "ObjectPool.h"
+
+#include <new>
+
+#include "customallocator.hpp"
+#include "helpers.h"
+
+using namespace HEIFPP;
+
+const std::size_t ObjectPool::Alignment     = alignof(std::max_align_t);
+const std::size_t ObjectPool::HeaderSize    = (sizeof(ObjectPool::Header) + Alignment - 1) / Alignment * Alignment;
+const std::size_t ObjectPool::ChunkSize     = 64 * 1024;
+const std::size_t ObjectPool::MaxPooledSize = 1024;
+
+ObjectPool::ObjectPool()
+    : mChunks()
+    , mCursor(nullptr)
+    , mRemaining(0)
+    , mFreeLists(MaxPooledSize / Alignment + 1, nullptr)
+    , mLiveCount(0)
+{
+}
+
+ObjectPool::~ObjectPool()
+{
+    // all objects must have been deleted before their Heif. If some are still alive, their memory is leaked rather
+    // than freed under them.
+    HEIF_ASSERT(mLiveCount == 0);
+    if (mLiveCount != 0)
+    {
+        return;
+    }
+    for (auto* chunk : mChunks)
+    {
+        customDeallocate(chunk);
+    }
+}
+
+void* ObjectPool::allocate(std::size_t aSize, ObjectPool* aPool)
+{
+    const std::size_t size = (aSize + HeaderSize + Alignment - 1) / Alignment * Alignment;
+    Header* header         = nullptr;
+    if ((aPool != nullptr) && (size <= MaxPooledSize))
+    {
+        header = aPool->take(size / Alignment);
+    }
+    else
+    {
+        header            = static_cast<Header*>(allocateMemory(size));
+        header->pool      = nullptr;
+        header->sizeClass = 0;
+    }
+    return reinterpret_cast<std::uint8_t*>(header) + HeaderSize;
+}
+
+void ObjectPool::deallocate(void* aObject)
+{
+    if (aObject == nullptr)
+    {
+        return;
+    }
+    Header* header = reinterpret_cast<Header*>(static_cast<std::uint8_t*>(aObject) - HeaderSize);
+    if (header->pool)
+    {
+        header->pool->give(header);
+    }
+    else
+    {
+        customDeallocate(header);
+    }
+}
+
+void ObjectPool::release()
+{
+    if (mLiveCount != 0)
+    {
+        return;
+    }
+    for (auto* chunk : mChunks)
+    {
+        customDeallocate(chunk);
+    }
+    mChunks.clear();
+    mFreeLists.assign(mFreeLists.size(), nullptr);
+    mCursor    = nullptr;
+    mRemaining = 0;
+}
+
+void* ObjectPool::allocateMemory(std::size_t aSize)
+{
+    void* memory = customAllocate(aSize);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+ObjectPool::Header* ObjectPool::take(std::size_t aSizeClass)
+{
+    Header* header = mFreeLists[aSizeClass];
+    if (header)
+    {
+        // a free header holds the next free header in place of the pool pointer.
+        mFreeLists[aSizeClass] = reinterpret_cast<Header*>(header->pool);
+    }
+    else
+    {
+        const std::size_t size = aSizeClass * Alignment;
+        if (mRemaining < size)
+        {
+            mCursor = static_cast<std::uint8_t*>(allocateMemory(ChunkSize));
+            mChunks.push_back(mCursor);
+            mRemaining = ChunkSize;
+        }
+        header = reinterpret_cast<Header*>(mCursor);
+        mCursor += size;
+        mRemaining -= size;
+    }
+    header->pool      = this;
+    header->sizeClass = aSizeClass;
+    ++mLiveCount;
+    return header;
+}
+
+void ObjectPool::give(Header* aHeader)
+{
+    const std::size_t sizeClass = aHeader->sizeClass;
+    aHeader->pool               = reinterpret_cast<ObjectPool*>(mFreeLists[sizeClass]);
+    mFreeLists[sizeClass]       = aHeader;
+    --mLiveCount;
+}
+
+void* PooledObject::operator new(std::size_t aSize)
+{
+    return ObjectPool::allocate(aSize, nullptr);
+}
+
+void* PooledObject::operator new(std::size_t aSize, ObjectPool& aPool)
+{
+    return ObjectPool::allocate(aSize, &aPool);
+}
+
+void PooledObject::operator delete(void* aObject)
+{
+    ObjectPool::deallocate(aObject);
+}
+
+void PooledObject::operator delete(void* aObject, ObjectPool&)
+{
+    ObjectPool::deallocate(aObject);
+}
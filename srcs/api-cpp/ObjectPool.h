@@ -0,0 +1,84 @@
+/*
+ * This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2025 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved. Copying, including reproducing, storing, adapting or translating, any or all
+ * of this material requires the prior written consent of Nokia.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace HEIFPP
+{
+    /** @brief Memory for the objects of one Heif instance.
+     *  Memory is taken from the custom allocator of the library (see HEIF::CustomAllocator) in large chunks which are
+     *  handed out in order. Memory of deleted objects is kept in a free list per object size and reused for new objects
+     *  of the same size, e.g. while editing. Chunks are freed together with release(), so loading and tearing down a
+     *  large file does a few allocations instead of one per object. */
+    class ObjectPool
+    {
+    public:
+        ObjectPool();
+        ~ObjectPool();
+
+        /** Allocates memory for an object, directly from the custom allocator if the object is too large to be pooled.
+         *  @param [in] aSize Size of the object.
+         *  @param [in] aPool Pool to allocate from, or nullptr to allocate directly from the custom allocator. */
+        static void* allocate(std::size_t aSize, ObjectPool* aPool);
+
+        /** Frees memory returned by allocate(), to the pool it was allocated from or to the custom allocator. */
+        static void deallocate(void* aObject);
+
+        /** Frees the chunks of the pool, if no object allocated from it is alive anymore. */
+        void release();
+
+    private:
+        struct Header
+        {
+            ObjectPool* pool;
+            std::size_t sizeClass;
+        };
+
+        static const std::size_t Alignment;
+        static const std::size_t HeaderSize;
+        static const std::size_t ChunkSize;
+        static const std::size_t MaxPooledSize;
+
+        /** @return Memory from the custom allocator. Throws std::bad_alloc if the allocator fails. */
+        static void* allocateMemory(std::size_t aSize);
+
+        Header* take(std::size_t aSizeClass);
+        void give(Header* aHeader);
+
+        std::vector<std::uint8_t*> mChunks;
+        std::uint8_t* mCursor;
+        std::size_t mRemaining;
+        std::vector<Header*> mFreeLists;  ///< Free list heads by size class, linked through the freed memory.
+        std::size_t mLiveCount;           ///< Objects allocated from the pool and not yet freed.
+
+        ObjectPool& operator=(const ObjectPool&) = delete;
+        ObjectPool& operator=(ObjectPool&&) = delete;
+        ObjectPool(const ObjectPool&)       = delete;
+        ObjectPool(ObjectPool&&)            = delete;
+    };
+
+    /** @brief Base of objects which Heif allocates from its ObjectPool with new (pool) Type(...).
+     *  Objects created with plain new are allocated directly from the custom allocator. Both are deleted with plain
+     *  delete. */
+    class PooledObject
+    {
+    public:
+        static void* operator new(std::size_t aSize);
+        static void* operator new(std::size_t aSize, ObjectPool& aPool);
+        static void operator delete(void* aObject);
+        static void operator delete(void* aObject, ObjectPool& aPool);
+    };
+}  // namespace HEIFPP
@@ -440,24 +440,33 @@ HEIF::ErrorCode Sample::save(HEIF::Writer* aWriter)
     HEIF::Data data;
 
     data.mediaFormat = mConfig->getMediaFormat();
-    switch (data.mediaFormat)
-    {
-    case HEIF::MediaFormat::AVC:
-    case HEIF::MediaFormat::HEVC:
+    if (mBuffer == nullptr)
     {
-        err       = NAL_State::convertFromByteStream(mBuffer, mBufferSize, aData, aSize)
-                        ? HEIF::ErrorCode::OK
-                        : HEIF::ErrorCode::MEDIA_PARSING_ERROR;
-        data.data = aData;
-        data.size = mBufferSize;
-        break;
+        // Data not loaded, a pass-through save copies it as stored in the loaded file.
+        err = getHeif()->readPassThroughData(this, mBufferSize, data);
     }
-    default:
+    if ((mBuffer != nullptr) || (HEIF::ErrorCode::NOT_APPLICABLE == err))
     {
-        data.data = mBuffer;
-        data.size = mBufferSize;
-        break;
-    }
+        err = HEIF::ErrorCode::OK;
+        switch (data.mediaFormat)
+        {
+        case HEIF::MediaFormat::AVC:
+        case HEIF::MediaFormat::HEVC:
+        {
+            err       = NAL_State::convertFromByteStream(mBuffer, mBufferSize, aData, aSize)
+                            ? HEIF::ErrorCode::OK
+                            : HEIF::ErrorCode::MEDIA_PARSING_ERROR;
+            data.data = aData;
+            data.size = mBufferSize;
+            break;
+        }
+        default:
+        {
+            data.data = mBuffer;
+            data.size = mBufferSize;
+            break;
+        }
+        }
     }
     if (HEIF::ErrorCode::OK != err)
     {
@@ -18,7 +18,7 @@ namespace HEIFPP
 {
     class Track;
 
-    class Sample
+    class Sample : public PooledObject
     {
         friend class EntityGroup;
         friend class Heif;
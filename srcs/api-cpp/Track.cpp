@@ -12,6 +12,9 @@
 
 #include "Track.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "AlternativeTrackGroup.h"
 #include "DecoderConfiguration.h"
 #include "EntityGroup.h"
@@ -99,15 +102,23 @@ HEIF::ErrorCode Track::load(HEIF::Reader* aReader, const HEIF::SequenceId& aId)
     mTimeScale     = info->timeScale;
     // load samples..
     mSamples.resize(info->sampleProperties.size);
-    for (uint32_t id = 0; id < info->sampleProperties.size; id++)
+    if (mHeif->mPreLoadMode == Heif::PreloadMode::LOAD_ON_DEMAND)
+    {
+        // constructed on first access, see loadSample().
+        mPendingSamples.assign(mSamples.size(), true);
+    }
+    else
     {
-        const auto& at = info->sampleProperties[id];
-        Sample* sample = mHeif->constructSample(aReader, mId, at, error);
-        if (HEIF::ErrorCode::OK != error)
+        for (uint32_t id = 0; id < info->sampleProperties.size; id++)
         {
-            return error;
+            const auto& at = info->sampleProperties[id];
+            Sample* sample = mHeif->constructSample(aReader, mId, at, error);
+            if (HEIF::ErrorCode::OK != error)
+            {
+                return error;
+            }
+            setSample(id, sample);
         }
-        setSample(id, sample);
     }
     // store the edit list..
     if (mFeatures & HEIF::TrackFeatureEnum::Feature::HasEditList)
@@ -639,20 +650,139 @@ std::uint32_t Track::getSampleCount() const
 
 Sample* Track::getSample(std::uint32_t aId)
 {
-    if (aId < mSamples.size())
+    HEIF::ErrorCode error = HEIF::ErrorCode::OK;
+    return loadSample(aId, error);
+}
+
+Sample* Track::getSample(std::uint32_t aId) const
+{
+    // constructing a sample on first access does not change the track as seen by the user.
+    HEIF::ErrorCode error = HEIF::ErrorCode::OK;
+    return const_cast<Track*>(this)->loadSample(aId, error);
+}
+
+Sample* Track::loadSample(std::uint32_t aIndex, HEIF::ErrorCode& aErrorCode)
+{
+    aErrorCode = HEIF::ErrorCode::OK;
+    if (aIndex >= mSamples.size())
     {
-        return mSamples[aId];
+        return nullptr;
     }
-    return nullptr;
+    if ((aIndex >= mPendingSamples.size()) || !mPendingSamples[aIndex])
+    {
+        return mSamples[aIndex];
+    }
+
+    HEIF::Reader* reader = mHeif->getReaderInstance();
+    const auto* info     = mHeif->getTrackInformation(mId);
+    if ((reader == nullptr) || (info == nullptr))
+    {
+        aErrorCode = HEIF::ErrorCode::UNINITIALIZED;
+        return nullptr;
+    }
+
+    // Decode dependencies can chain through a long run of samples, so they are resolved with a work list instead of
+    // recursion.
+    std::vector<std::uint32_t> unresolved;
+    if (constructPendingSample(reader, *info, aIndex, aErrorCode))
+    {
+        unresolved.push_back(aIndex);
+    }
+    while (!unresolved.empty())
+    {
+        const std::uint32_t index = unresolved.back();
+        unresolved.pop_back();
+        Sample* sample = mSamples[index];
+
+        HEIF::Array<HEIF::SequenceImageId> dependencies;
+        reader->getDecodeDependencies(mId, info->sampleProperties[index].sampleId, dependencies);
+        for (auto sid : dependencies)
+        {
+            const std::uint32_t dependency = indexOfSample(*info, sid);
+            if (dependency >= mSamples.size())
+            {
+                continue;
+            }
+            if ((dependency < mPendingSamples.size()) && mPendingSamples[dependency])
+            {
+                HEIF::ErrorCode error = HEIF::ErrorCode::OK;
+                if (constructPendingSample(reader, *info, dependency, error))
+                {
+                    unresolved.push_back(dependency);
+                }
+                else if (HEIF::ErrorCode::OK == aErrorCode)
+                {
+                    aErrorCode = error;
+                }
+            }
+            if (mSamples[dependency])
+            {
+                sample->addDecodeDependency(mSamples[dependency]);
+            }
+        }
+    }
+    return mSamples[aIndex];
 }
 
-Sample* Track::getSample(std::uint32_t aId) const
+Sample* Track::loadSampleById(const HEIF::SequenceImageId& aSampleId, HEIF::ErrorCode& aErrorCode)
 {
-    if (aId < mSamples.size())
+    const auto* info = mHeif->getTrackInformation(mId);
+    if (info == nullptr)
     {
-        return mSamples[aId];
+        aErrorCode = HEIF::ErrorCode::UNINITIALIZED;
+        return nullptr;
     }
-    return nullptr;
+    return loadSample(indexOfSample(*info, aSampleId), aErrorCode);
+}
+
+HEIF::ErrorCode Track::loadSamples()
+{
+    HEIF::ErrorCode result = HEIF::ErrorCode::OK;
+    for (std::uint32_t index = 0; index < mPendingSamples.size(); index++)
+    {
+        HEIF::ErrorCode error = HEIF::ErrorCode::OK;
+        loadSample(index, error);
+        if ((HEIF::ErrorCode::OK != error) && (HEIF::ErrorCode::OK == result))
+        {
+            result = error;
+        }
+    }
+    if (HEIF::ErrorCode::OK == result)
+    {
+        mPendingSamples.clear();
+    }
+    return result;
+}
+
+std::uint32_t Track::indexOfSample(const HEIF::TrackInformation& aInfo, const HEIF::SequenceImageId& aSampleId) const
+{
+    // sample ids grow with the sample index.
+    const auto* it = std::lower_bound(aInfo.sampleProperties.begin(), aInfo.sampleProperties.end(), aSampleId,
+                                      [](const HEIF::SampleInformation& aSample, const HEIF::SequenceImageId& aId) {
+                                          return aSample.sampleId < aId;
+                                      });
+    if ((it != aInfo.sampleProperties.end()) && (it->sampleId == aSampleId))
+    {
+        return static_cast<std::uint32_t>(it - aInfo.sampleProperties.begin());
+    }
+    return static_cast<std::uint32_t>(mSamples.size());
+}
+
+Sample* Track::constructPendingSample(HEIF::Reader* aReader,
+                                      const HEIF::TrackInformation& aInfo,
+                                      std::uint32_t aIndex,
+                                      HEIF::ErrorCode& aErrorCode)
+{
+    aErrorCode     = HEIF::ErrorCode::OK;
+    Sample* sample = mHeif->createSample(aReader, mId, aInfo.sampleProperties[aIndex], aErrorCode);
+    if (HEIF::ErrorCode::OK != aErrorCode)
+    {
+        // not usable without its decoder configuration. The slot stays pending, so the error is not lost.
+        delete sample;
+        return nullptr;
+    }
+    setSample(aIndex, sample);
+    return sample;
 }
 
 Sample* Track::getSampleByType(HEIF::TrackSampleType, std::uint32_t)
@@ -667,6 +797,10 @@ Sample* Track::getSampleByType(HEIF::TrackSampleType, std::uint32_t) const
 
 void Track::setSample(std::uint32_t aId, Sample* aSample)
 {
+    if (aId < mPendingSamples.size())
+    {
+        mPendingSamples[aId] = false;
+    }
     if (aId < mSamples.size())
     {
         Sample*& s = mSamples.at(aId);
@@ -684,8 +818,14 @@ void Track::setSample(std::uint32_t aId, Sample* aSample)
 
 void Track::setSample(Sample* aOldSample, Sample* aNewSample)
 {
-    for (Sample*& s : mSamples)
+    for (std::uint32_t index = 0; index < mSamples.size(); index++)
     {
+        Sample*& s = mSamples[index];
+        if ((index < mPendingSamples.size()) && mPendingSamples[index])
+        {
+            // not constructed yet.
+            continue;
+        }
         if (s == aOldSample)
         {
             if (s)
@@ -716,6 +856,16 @@ void Track::addSample(Sample* aSample)
 
 void Track::removeSample(Sample* aSample)
 {
+    // indices of the samples change, construct pending samples while they can still be found.
+    if ((HEIF::ErrorCode::OK != loadSamples()) && !mPendingSamples.empty())
+    {
+        // samples which could not be loaded stay pending, keep their flags in step with the samples.
+        const auto it = std::find(mSamples.rbegin(), mSamples.rend(), aSample);
+        if (it != mSamples.rend())
+        {
+            mPendingSamples.erase(mPendingSamples.begin() + (std::distance(it, mSamples.rend()) - 1));
+        }
+    }
     if (RemoveItemFrom(mSamples, aSample))
     {
         aSample->unlink(this);
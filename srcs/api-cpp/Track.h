@@ -155,6 +155,24 @@ namespace HEIFPP
         void setSample(std::uint32_t, Sample* aSample);
         void setSample(Sample* aOldSample, Sample* aNewSample);
 
+        /** Constructs the sample with the given index from the loaded file, if it has not been constructed yet.
+         *  With PreloadMode::LOAD_ON_DEMAND samples are constructed on first access instead of during load.
+         *  Samples the sample has decode dependencies on are constructed as well. A sample which could not be loaded
+         *  stays pending, so the error is reported again on the next access.
+         *  @param [in] aIndex: Index of the sample.
+         *  @param [out] aErrorCode: Error of loading the sample or one of its decode dependencies.
+         *  @return Sample*: The sample, or nullptr if there is no such sample or it could not be loaded. */
+        Sample* loadSample(std::uint32_t aIndex, HEIF::ErrorCode& aErrorCode);
+
+        /** Constructs the sample with the given id in the loaded file, see loadSample().
+         *  @param [in] aSampleId: Id of the sample in the loaded file.
+         *  @param [out] aErrorCode: Error of loading the sample or one of its decode dependencies. */
+        Sample* loadSampleById(const HEIF::SequenceImageId& aSampleId, HEIF::ErrorCode& aErrorCode);
+
+        /** Constructs all samples which have not been constructed yet, see loadSample().
+         *  @return ErrorCode: The first error of loading a sample. */
+        HEIF::ErrorCode loadSamples();
+
         // serialization methods.
         virtual HEIF::ErrorCode load(HEIF::Reader* aReader, const HEIF::SequenceId& aId);
         virtual HEIF::ErrorCode save(HEIF::Writer* aWriter);
@@ -179,6 +197,7 @@ namespace HEIFPP
         LinkArray<Track*> mIsThumbnailTo;
         LinkArray<Track*> mIsAuxiliaryTo;
         std::vector<Sample*> mSamples;
+        std::vector<bool> mPendingSamples;  ///< Samples of the loaded file which are not constructed yet, by index.
         std::vector<EntityGroup*> mGroups;
         class EditList
         {
@@ -198,5 +217,11 @@ namespace HEIFPP
         Track(const Track&)       = delete;
         Track(Track&&)            = delete;
         Track()                   = delete;
+
+        std::uint32_t indexOfSample(const HEIF::TrackInformation& aInfo, const HEIF::SequenceImageId& aSampleId) const;
+        Sample* constructPendingSample(HEIF::Reader* aReader,
+                                       const HEIF::TrackInformation& aInfo,
+                                       std::uint32_t aIndex,
+                                       HEIF::ErrorCode& aErrorCode);
     };
 }  // namespace HEIFPP
@@ -12,6 +12,7 @@
 
 #include "helpers.h"
 
+#include <iterator>
 #include <limits>
 
 #include "Heif.h"
@@ -36,14 +37,15 @@ namespace HEIFPP
     {
         if (aTarget)
         {
-            for (auto it = mList.begin(); it != mList.end(); ++it)
+            // search from the end, recently added links are usually removed first.
+            for (auto it = mList.rbegin(); it != mList.rend(); ++it)
             {
                 if (aTarget == it->first)
                 {
                     it->second--;
                     if (it->second == 0)
                     {
-                        mList.erase(it);
+                        mList.erase(std::next(it).base());
                     }
                     return true;
                 }
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cstdint>
+#include <iterator>
 #include <map>
 #include <vector>
 #if (defined(_DEBUG) || defined(DEBUG)) || (!defined(NDEBUG))
@@ -40,11 +41,12 @@ namespace HEIFPP
     template <class type>
     bool RemoveItemFrom(std::vector<type>& list, type item)
     {
-        for (auto it = list.begin(); it != list.end(); ++it)
+        // search from the end, recently added items are usually removed first.
+        for (auto it = list.rbegin(); it != list.rend(); ++it)
         {
             if (item == *it)
             {
-                list.erase(it);
+                list.erase(std::next(it).base());
                 return true;
             }
         }
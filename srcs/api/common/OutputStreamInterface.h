@@ -16,6 +16,7 @@
 
 #include <cstdint>
 
+#include "heifcommondatatypes.h"
 #include "heifexport.h"
 
 namespace HEIF
@@ -23,6 +24,13 @@ namespace HEIF
     class HEIF_DLL_PUBLIC OutputStreamInterface
     {
     public:
+        /** Buffer of data for writeBuffers() */
+        struct Buffer
+        {
+            const void* data;
+            std::uint64_t size;
+        };
+
         virtual ~OutputStreamInterface() = default;
 
         /** Sets current write position
@@ -50,6 +58,39 @@ namespace HEIF
         virtual const uint8_t* data() = 0;
         virtual std::uint64_t size() = 0;
 
+        /** Writes several buffers to stream in the given order, as if write() was called for each of them.
+         *  Lets the writer output box headers and their payload without first concatenating them to one buffer.
+         *  The default implementation calls write() for each buffer.
+         * @param buffers [in] The buffers of data to write to the stream.
+         * @param count   [in] The number of buffers.
+         */
+        virtual void writeBuffers(const Buffer* buffers, std::uint64_t count)
+        {
+            for (std::uint64_t i = 0; i < count; ++i)
+            {
+                write(buffers[i].data, buffers[i].size);
+            }
+        }
+
+        /** Hint of the total stream size, so that a stream can allocate its storage once.
+         *  Writer calls this before writing the file content it has collected in memory.
+         *  The default implementation ignores the hint.
+         * @param capacity [in] Expected size of the stream in bytes.
+         */
+        virtual void reserve(std::uint64_t /*capacity*/)
+        {
+        }
+
+        /** Hands the written data over to the caller without a copy, and leaves the stream empty.
+         *  Supported by streams created with ConstructMemoryStream(). Call after Writer::finalize().
+         * @param buffer [out] The written data. Previous content of the array is released.
+         * @return True if the stream supports releasing its buffer.
+         */
+        virtual bool releaseBuffer(Array<std::uint8_t>& /*buffer*/)
+        {
+            return false;
+        }
+
     protected:
         OutputStreamInterface()        = default;                                 // ctor
         OutputStreamInterface& operator=(const OutputStreamInterface&) = delete;  // copy assignment
@@ -60,6 +101,9 @@ namespace HEIF
 
     OutputStreamInterface* ConstructFileStream(const char* aFilename);
 
-    HEIF_DLL_PUBLIC OutputStreamInterface* ConstructMemoryStream();
+    /** Creates a stream that writes to memory.
+     * @param initialCapacity [in] Initial size of the memory buffer in bytes. The buffer grows as needed.
+     */
+    HEIF_DLL_PUBLIC OutputStreamInterface* ConstructMemoryStream(std::uint64_t initialCapacity = 0);
 }  // namespace HEIF
 #endif
@@ -66,6 +66,29 @@ namespace HEIF
             StreamInterface::IndeterminateSize if the file size cannot be determined.
          */
         virtual offset_t size() = 0;
+
+        /** Reads data from the given offset without using or modifying the
+            current offset of the stream. Implementations overriding this
+            must allow concurrent calls from several threads.
+
+            @param [offset] Offset to read from
+            @param [buffer] The buffer to write the data into
+            @param [size]   The number of bytes to read from the stream
+            @returns The number of bytes read, or 0 on EOF. A negative value
+            indicates that positional reads are not supported by the stream,
+            which is what the default implementation returns.
+         */
+        virtual offset_t readAt(offset_t offset, char* buffer, offset_t size);
+
+        /** Retrieve direct access to the stream contents. Streams that keep the whole
+            source addressable in memory (e.g. a memory mapped file) may override this to
+            allow zero-copy access. The returned pointer must stay valid for the lifetime
+            of the stream object.
+
+            @returns Pointer to the first byte of the stream, or nullptr if direct
+            access is not supported. The default implementation returns nullptr.
+         */
+        virtual const char* data();
     };
 }  // namespace HEIF
 
@@ -24,7 +24,12 @@ namespace HEIF
 {
     class StreamInterface;
 
-    /** Interface for reading an High Efficiency Image File Format (HEIF) file. */
+    /** Interface for reading an High Efficiency Image File Format (HEIF) file.
+     *
+     *  Once initialize() has returned successfully, the item and sample data accessors (getItemData(),
+     *  getItemDataWithDecoderParameters() and getItemDataView()) may be called concurrently from several threads.
+     *  Data is then read with positional reads (StreamInterface::readAt()); streams not supporting those are accessed
+     *  under a lock. initialize() and close() must not be called concurrently with any other method. */
     class HEIF_DLL_PUBLIC Reader
     {
     public:
@@ -58,6 +63,26 @@ namespace HEIF
 
         /*---------- Interface methods are defined as follows:--------------------- */
 
+        /** Defer expanding the sample tables of image sequence tracks until they are first needed.
+         *  Opening a long sequence then costs no more than its box headers. Sample data and decoder
+         *  configurations are located directly from the 'stbl' boxes, so e.g. reading the first sample
+         *  does not expand the table; other per-sample accessors expand the table of their track.
+         *  Fragmented files are always expanded at initialize().
+         *  In lazy mode FileInformation::trackInformation carries no sampleProperties for tracks that
+         *  have not been expanded; use getTrackInformations() to get them.
+         *  Must be called before initialize().
+         *  @param [in] lazy True to expand sample tables on demand, false (default) to expand them at initialize().
+         *  @return ErrorCode: OK, ALREADY_INITIALIZED */
+        virtual ErrorCode setLazySampleTables(bool lazy) = 0;
+
+        /** Set the size of the read-ahead buffer used when parsing the file structure from a stream.
+         *  Box headers are parsed with small reads, which the buffer combines into reads of this size.
+         *  Streams returning their contents with StreamInterface::data() are not buffered.
+         *  Must be called before initialize().
+         *  @param [in] size Buffer size in bytes, 64 KiB by default. 0 reads only the requested bytes.
+         *  @return ErrorCode: OK, ALREADY_INITIALIZED */
+        virtual ErrorCode setReadAheadSize(std::uint32_t size) = 0;
+
         /** Open a file for reading and read the file header information.
          *  @param [in] fileName File to open.
          *  @return ErrorCode: OK, FILE_OPEN_ERROR, FILE_READ_ERROR, FILE_HEADER_ERROR */
@@ -68,6 +93,24 @@ namespace HEIF
          *  @return ErrorCode: OK, FILE_HEADER_ERROR, FILE_READ_ERROR */
         virtual ErrorCode initialize(StreamInterface* input) = 0;
 
+        /** Open a file and read only what is needed to identify its images, e.g. for indexing many files.
+         *  Of the root level boxes only 'ftyp' and 'meta' are parsed. Other boxes are skipped by their headers, and
+         *  reading stops after the 'meta' box. When 'meta' precedes 'mdat', the file is usually read with a single
+         *  read of the read-ahead buffer size, see setReadAheadSize().
+         *  Afterwards the image item accessors can be used as after initialize(), but image sequences and tracks are
+         *  not available and getFileInformation() returns no information. Call close() or initialize() to read the
+         *  whole file.
+         *  @param [in]  fileName  File to open.
+         *  @param [out] probeInfo Summary of the file.
+         *  @return ErrorCode: OK, FILE_OPEN_ERROR, FILE_READ_ERROR, FILE_HEADER_ERROR */
+        virtual ErrorCode probe(const char* fileName, ProbeInformation& probeInfo) = 0;
+
+        /** Open an input stream and read only what is needed to identify its images, as probe(const char*).
+         *  @param [in]  input     Stream to open.
+         *  @param [out] probeInfo Summary of the file.
+         *  @return ErrorCode: OK, FILE_OPEN_ERROR, FILE_READ_ERROR, FILE_HEADER_ERROR */
+        virtual ErrorCode probe(StreamInterface* input, ProbeInformation& probeInfo) = 0;
+
         /** Reset reader internal state. */
         virtual void close() = 0;
 
@@ -100,6 +143,16 @@ namespace HEIF
          *  @return ErrorCode: OK or UNINITIALIZED */
         virtual ErrorCode getFileInformation(FileInformation& fileinfo) const = 0;
 
+        /** Get file information without copying it.
+         *  Gives read-only access to the file information held by the reader, e.g. to enumerate items, tracks and
+         *  sample properties of long image sequences without allocations.
+         *  The information is valid until close(), initialize(), probe(), parseInitializationSegment(),
+         *  parseSegment() or invalidateSegment() is called, or the reader is destroyed.
+         *  @pre initialize() has been called successfully.
+         *  @param [out] fileinfo Pointer to the FileInformation struct of the reader.
+         *  @return ErrorCode: OK or UNINITIALIZED */
+        virtual ErrorCode getFileInformation(const FileInformation*& fileinfo) const = 0;
+
         /** Get track information.
          *  These properties can be used to further initialize the presentation of the data in the track.
          *  Properties also give hints about the way and means to request data from the track.
@@ -297,6 +350,37 @@ namespace HEIF
                                       uint64_t& memoryBufferSize,
                                       bool bytestreamHeaders = true) = 0;
 
+        /** Get data of several items with one call.
+         *  Behaves as calling getItemData() for each item, but resolves the locations of all items first and reads
+         *  data stored in the file in ascending offset order, merging adjacent or nearby extents into larger reads.
+         *  This is beneficial e.g. for reading all tiles of a grid image.
+         *  @param [in]      imageIds          Item ids of the images.
+         *  @param [in,out]  buffers           Destination buffer for each item, in the same order as imageIds. On
+         *                                     return memoryBufferSize holds the size of the item data. If any buffer
+         *                                     is too small, sizes of all items are set and no data is read.
+         *  @param [in]      bytestreamHeaders Optional - by default true. Whether to substitute H.264/H.265
+         *                                     nal-lenght values with bytestream header (0001).
+         *  @pre initialize() has been called successfully.
+         *  @return ErrorCode: OK, UNINITIALIZED, INVALID_FUNCTION_PARAMETER, INVALID_ITEM_ID, BUFFER_SIZE_TOO_SMALL,
+         *                     FILE_READ_ERROR */
+        virtual ErrorCode getItemDataBatch(const Array<ImageId>& imageIds,
+                                           Array<ItemDataBuffer>& buffers,
+                                           bool bytestreamHeaders = true) const = 0;
+
+        /** Get a read-only view of item data without copying it.
+         *  This is possible only when the reader was initialized from a stream which provides direct access to its
+         *  contents (StreamInterface::data(), e.g. a memory mapped file) and the item is stored as a single extent in
+         *  the file. The view contains the item data exactly as stored, i.e. nal-length values are not substituted
+         *  with bytestream headers. The view is valid as long as the reader instance exists.
+         *  @param [in]  imageId   Item id of the image.
+         *  @param [out] data      Pointer to the first byte of the item data.
+         *  @param [out] dataSize  Size of the item data in bytes.
+         *  @pre initialize() has been called successfully.
+         *  @return ErrorCode: OK, UNINITIALIZED, INVALID_ITEM_ID, FILE_READ_ERROR or NOT_APPLICABLE if the stream
+         *          does not support direct access or the item is not stored as a single extent in the file. In the
+         *          latter case getItemData() must be used instead. */
+        virtual ErrorCode getItemDataView(const ImageId& imageId, const uint8_t*& data, uint64_t& dataSize) const = 0;
+
         /** Get data of an image overlay item (item type 'iovl').
          *  @param [in]  imageId   Id of Image overlay item
          *  @param [out] iovlItem  Overlay derived item struct with requested data.
@@ -527,6 +611,22 @@ namespace HEIF
                                                 const SequenceImageId& imageId,
                                                 Array<SequenceImageId>& dependencies) const = 0;
 
+        /** Get samples to decode for presenting a track/sequence from a given time, e.g. when seeking.
+         *  The presented sample is the one with the greatest display timestamp not after timestamp, or the first
+         *  presented sample if timestamp is before it. Decoding starts from the nearest sync sample at or before the
+         *  presented sample in decoding order. Uses an index of the track which is built on the first call, so
+         *  subsequent calls do not scan the samples.
+         *  @param [in]  sequenceId Image sequence ID (track ID).
+         *  @param [in]  timestamp  Display timestamp in milliseconds, see getItemTimestamps().
+         *  @param [out] samples    Samples in decoding order, from the sync sample to start decoding from, to the
+         *                          sample to present.
+         *  @pre initialize() has been called successfully.
+         *  @return ErrorCode: OK, UNINITIALIZED, INVALID_SEQUENCE_ID, INVALID_SEQUENCE_IMAGE_ID if the track has no
+         *                     presented samples */
+        virtual ErrorCode getSeekSamples(const SequenceId& sequenceId,
+                                         std::int64_t timestamp,
+                                         Array<SequenceImageId>& samples) const = 0;
+
         /** Retrieve decoding dependencies for given image id, in decoding order.
          *  Information here comes from "pred" item references referenced from itemId.
          *  @param [in]  imageId       Identifier of an image.
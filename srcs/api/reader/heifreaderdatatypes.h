@@ -152,6 +152,13 @@ namespace HEIF
         Array<DecoderSpecificInfo> decoderSpecificInfo;  ///< Actual decoder specific information (type + payload).
     };
 
+    /** Destination of a single item in Reader::getItemDataBatch(). */
+    struct HEIF_DLL_PUBLIC ItemDataBuffer
+    {
+        uint8_t* memoryBuffer;      ///< Memory buffer where data is to be written to.
+        uint64_t memoryBufferSize;  ///< [in] Memory buffer size, [out] size of the item data.
+    };
+
     typedef uint32_t FeatureBitMask;
 
     struct HEIF_DLL_PUBLIC ItemInformation
@@ -363,6 +370,19 @@ namespace HEIF
                                       ///< edit list processing where it is used for EditUnit.durationInMovieTS
     };
 
+    /** @brief Summary of a file read with Reader::probe(). */
+    struct HEIF_DLL_PUBLIC ProbeInformation
+    {
+        FourCC majorBrand;
+        FeatureBitMask features   = 0;      ///< bitmask of FileFeatureEnum's. Track features are not set.
+        uint32_t masterImageCount = 0;      ///< Number of master images in the root level 'meta' box
+        bool hasPrimaryItem       = false;  ///< True if the file has a primary item, and the following fields are set
+        uint32_t width            = 0;      ///< Width of the primary item from its 'ispe' property
+        uint32_t height           = 0;      ///< Height of the primary item from its 'ispe' property
+        ImageId primaryItemId;              ///< Id of the primary item
+        Array<ImageId> thumbnailIds;        ///< Thumbnail images of the primary item
+    };
+
     struct HEIF_DLL_PUBLIC SegmentInformation
     {
         SegmentId segmentId;       ///< segmentId for this DASH ISOBMFF On-Demand profile file byte range
@@ -63,6 +63,32 @@ namespace HEIF
          * image item. If false: Creation time properties are not created and associated automatically.
          */
         bool itemCreationTimes = false;
+
+        /**
+         * If either value is non-zero, image sequence and track samples are written as movie fragments while they are
+         * added, instead of keeping them until finalize(). A fragment ('sidx', 'moof' and 'mdat' boxes) is written
+         * when added samples reach fragmentSampleCount samples, or when any track reaches fragmentDuration
+         * milliseconds. Written samples are no longer held in memory.
+         *
+         * The file is written as with progressiveFile = false: 'ftyp' is written in initialize(), 'moov' with empty
+         * sample tables before the first fragment and 'meta' at the end of the file. Thus all tracks, their decoder
+         * configurations and track level properties must be added before the first fragment is written.
+         * Samples that are already written can not be referenced anymore (e.g. by setImageHidden(),
+         * addMetadataItemReference() or SampleInfo::referenceSamples). Sample groups are not written to fragments. */
+        std::uint32_t fragmentSampleCount = 0;
+        std::uint32_t fragmentDuration    = 0;
+
+        /**
+         * If true: Media data fed with feedMediaData() which has the same content hash, size, media format and
+         * decoder configuration as earlier fed media data is not stored again, and the MediaDataId of the earlier
+         * data is returned. If false: Every fed media data is stored. */
+        bool deduplicateMediaData = true;
+
+        /**
+         * If true: Before earlier media data is reused by deduplicateMediaData, the contents are also compared byte by
+         * byte. Comparison is only possible while the earlier data is held in memory, so when progressiveFile = false
+         * or the data has already been written in a movie fragment, the media data is stored again instead. */
+        bool compareDeduplicatedMediaData = false;
     };
 
     enum class MediaFormat
@@ -0,0 +1,497 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2025 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+/** Benchmark of the reader and writer hot paths on synthetic files generated in memory.
+ *  An image collection file (coded image items and a grid of them), an image sequence file and optionally a fragmented
+ *  image sequence file are written, and then read back. Reported are Writer::finalize() time, Reader::initialize()
+ *  latency, item and sample data throughput, and peak heap use measured through a counting CustomAllocator. The
+ *  peak heap use reported for Writer::finalize() covers writing the whole file.
+ *  Usage: heif_bench [image items] [grid columns] [sequence samples] [samples per fragment] [data size in KB]
+ *                    [iterations] */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "heifreader.h"
+#include "heifstreaminterface.h"
+#include "heifwriter.h"
+
+using namespace HEIF;
+
+namespace
+{
+    typedef std::vector<std::uint8_t> Bytes;
+
+    /// Counts live and peak heap bytes of the library. Installed before any reader or writer is created.
+    class CountingAllocator : public CustomAllocator
+    {
+    public:
+        void* allocate(size_t n, size_t size) override
+        {
+            const size_t bytes = n * size;
+            auto* block        = static_cast<std::uint64_t*>(std::malloc(bytes + HEADER_SIZE));
+            if (block == nullptr)
+            {
+                return nullptr;
+            }
+            *block = bytes;
+            mCurrent += bytes;
+            mPeak = std::max(mPeak, mCurrent);
+            ++mAllocations;
+            return reinterpret_cast<std::uint8_t*>(block) + HEADER_SIZE;
+        }
+
+        void deallocate(void* ptr) override
+        {
+            if (ptr != nullptr)
+            {
+                auto* block = reinterpret_cast<std::uint64_t*>(static_cast<std::uint8_t*>(ptr) - HEADER_SIZE);
+                mCurrent -= *block;
+                std::free(block);
+            }
+        }
+
+        /// Start a new measurement: the peak is counted from the bytes currently allocated.
+        void resetPeak()
+        {
+            mPeak        = mCurrent;
+            mBaseline    = mCurrent;
+            mAllocations = 0;
+        }
+
+        std::uint64_t peakSinceReset() const
+        {
+            return mPeak - mBaseline;
+        }
+
+        std::uint64_t allocationsSinceReset() const
+        {
+            return mAllocations;
+        }
+
+    private:
+        static const size_t HEADER_SIZE = 16;  // Keeps the returned blocks aligned as malloc() aligns them.
+
+        std::uint64_t mCurrent     = 0;
+        std::uint64_t mPeak        = 0;
+        std::uint64_t mBaseline    = 0;
+        std::uint64_t mAllocations = 0;
+    };
+
+    /// Read-only stream over a file generated in memory.
+    class MemoryInputStream : public StreamInterface
+    {
+    public:
+        explicit MemoryInputStream(const Bytes& data)
+            : mData(data)
+        {
+        }
+
+        offset_t read(char* buffer, offset_t size) override
+        {
+            const offset_t count = readAt(mPosition, buffer, size);
+            mPosition += count;
+            return count;
+        }
+
+        bool absoluteSeek(offset_t offset) override
+        {
+            if (offset < 0 || offset > size())
+            {
+                return false;
+            }
+            mPosition = offset;
+            return true;
+        }
+
+        offset_t tell() override
+        {
+            return mPosition;
+        }
+
+        offset_t size() override
+        {
+            return static_cast<offset_t>(mData.size());
+        }
+
+        offset_t readAt(offset_t offset, char* buffer, offset_t size) override
+        {
+            if (offset < 0 || offset >= this->size())
+            {
+                return 0;
+            }
+            const offset_t count = std::min(size, this->size() - offset);
+            std::memcpy(buffer, mData.data() + offset, static_cast<size_t>(count));
+            return count;
+        }
+
+        const char* data() override
+        {
+            return reinterpret_cast<const char*>(mData.data());
+        }
+
+    private:
+        const Bytes& mData;
+        offset_t mPosition = 0;
+    };
+
+    /// HEVC parameter sets of a 512x512 Main profile image.
+    const std::uint8_t HEVC_VPS[] = {0x00, 0x00, 0x00, 0x01, 0x40, 0x01, 0x0c, 0x01, 0xff, 0xff, 0x03, 0x10, 0x00, 0x00,
+                                     0x03, 0x00, 0xb0, 0x00, 0x00, 0x03, 0x00, 0x00, 0x03, 0x00, 0x96, 0xf0, 0x24};
+    const std::uint8_t HEVC_SPS[] = {0x00, 0x00, 0x00, 0x01, 0x42, 0x01, 0x01, 0x03, 0x10, 0x00, 0x00, 0x03, 0x00, 0xb0,
+                                     0x00, 0x00, 0x03, 0x00, 0x00, 0x03, 0x00, 0x96, 0xa0, 0x04, 0x02, 0x00, 0x80, 0x59,
+                                     0x7e, 0xe4, 0xc9, 0x6a, 0x6e, 0x04, 0x0c, 0x04, 0x05, 0xda, 0x14, 0x25};
+    const std::uint8_t HEVC_PPS[] = {0x00, 0x00, 0x00, 0x01, 0x44, 0x01, 0xc1, 0xe3, 0x06, 0x07, 0x61, 0x08};
+    const std::uint32_t IMAGE_SIZE = 512;
+
+    DecoderSpecificInfo makeParameterSet(const DecoderSpecInfoType type, const std::uint8_t* data, const size_t size)
+    {
+        DecoderSpecificInfo info;
+        info.decSpecInfoType = type;
+        info.decSpecInfoData = Array<std::uint8_t>(size);
+        std::memcpy(info.decSpecInfoData.elements, data, size);
+        return info;
+    }
+
+    /// Length-prefixed coded images: a single IDR NAL unit of random payload, distinct for each index.
+    Bytes makeCodedImage(const std::uint64_t size, const std::uint32_t index)
+    {
+        std::mt19937 random(index + 1);
+        Bytes image(std::max<std::uint64_t>(size, 8));
+        const auto nalLength = static_cast<std::uint32_t>(image.size() - 4);
+        image[0]             = static_cast<std::uint8_t>(nalLength >> 24);
+        image[1]             = static_cast<std::uint8_t>(nalLength >> 16);
+        image[2]             = static_cast<std::uint8_t>(nalLength >> 8);
+        image[3]             = static_cast<std::uint8_t>(nalLength);
+        image[4]             = 0x26;
+        image[5]             = 0x01;
+        for (size_t i = 6; i < image.size(); ++i)
+        {
+            image[i] = static_cast<std::uint8_t>(random());
+        }
+        return image;
+    }
+
+    struct Shape
+    {
+        std::uint32_t items;
+        std::uint32_t gridColumns;
+        std::uint32_t samples;
+        std::uint32_t samplesPerFragment;
+        std::uint64_t dataSize;
+    };
+
+    enum class FileKind
+    {
+        COLLECTION,
+        SEQUENCE,
+        FRAGMENTED
+    };
+
+    struct WriteResult
+    {
+        Bytes file;
+        double finalizeSeconds    = 0.0;
+        std::uint64_t peakBytes   = 0;
+        std::uint64_t allocations = 0;
+    };
+
+    bool check(const ErrorCode error, const char* what)
+    {
+        if (error != ErrorCode::OK)
+        {
+            std::fprintf(stderr, "%s failed with error %d\n", what, static_cast<int>(error));
+            return false;
+        }
+        return true;
+    }
+
+    bool writeFile(const FileKind kind,
+                   const Shape& shape,
+                   const std::vector<Bytes>& images,
+                   CountingAllocator& allocator,
+                   WriteResult& result)
+    {
+        OutputStreamInterface* stream = ConstructMemoryStream();
+        Writer* writer                = Writer::Create();
+        allocator.resetPeak();
+
+        OutputConfig config{};
+        config.outputStream        = stream;
+        config.progressiveFile     = (kind != FileKind::FRAGMENTED);
+        config.fragmentSampleCount = (kind == FileKind::FRAGMENTED) ? shape.samplesPerFragment : 0;
+        config.majorBrand          = (kind == FileKind::COLLECTION) ? "heic" : "msf1";
+        config.compatibleBrands    = Array<FourCC>(2);
+        config.compatibleBrands[0] = "heic";
+        config.compatibleBrands[1] = (kind == FileKind::COLLECTION) ? "mif1" : "hevc";
+
+        bool ok = check(writer->initialize(config), "Writer::initialize()");
+
+        Array<DecoderSpecificInfo> parameterSets(3);
+        parameterSets[0] = makeParameterSet(DecoderSpecInfoType::HEVC_VPS, HEVC_VPS, sizeof(HEVC_VPS));
+        parameterSets[1] = makeParameterSet(DecoderSpecInfoType::HEVC_SPS, HEVC_SPS, sizeof(HEVC_SPS));
+        parameterSets[2] = makeParameterSet(DecoderSpecInfoType::HEVC_PPS, HEVC_PPS, sizeof(HEVC_PPS));
+        DecoderConfigId decoderConfigId;
+        ok = ok && check(writer->feedDecoderConfig(parameterSets, decoderConfigId), "Writer::feedDecoderConfig()");
+
+        SequenceId sequenceId;
+        if (ok && kind != FileKind::COLLECTION)
+        {
+            CodingConstraints constraints{};
+            constraints.allRefPicsIntra = true;
+            constraints.intraPredUsed   = true;
+            constraints.maxRefPerPic    = 0;
+            ok = check(writer->addImageSequence({1, 30}, constraints, sequenceId), "Writer::addImageSequence()");
+        }
+
+        const std::uint32_t count = (kind == FileKind::COLLECTION) ? shape.items : shape.samples;
+        Array<ImageId> imageIds(count);
+        for (std::uint32_t i = 0; ok && i < count; ++i)
+        {
+            const Bytes& image = images[i % images.size()];
+            Data data;
+            data.mediaFormat     = MediaFormat::HEVC;
+            data.data            = const_cast<std::uint8_t*>(image.data());
+            data.size            = image.size();
+            data.decoderConfigId = decoderConfigId;
+            MediaDataId mediaDataId;
+            ok = check(writer->feedMediaData(data, mediaDataId), "Writer::feedMediaData()");
+            if (ok && kind == FileKind::COLLECTION)
+            {
+                ok = check(writer->addImage(mediaDataId, imageIds[i]), "Writer::addImage()");
+            }
+            else if (ok)
+            {
+                SampleInfo sampleInfo{};
+                sampleInfo.duration     = 1;
+                sampleInfo.isSyncSample = true;
+                SequenceImageId sampleId;
+                ok = check(writer->addImage(sequenceId, mediaDataId, sampleInfo, sampleId), "Writer::addImage()");
+            }
+        }
+
+        if (ok && kind == FileKind::COLLECTION)
+        {
+            const std::uint32_t tiles = shape.gridColumns * shape.gridColumns;
+            ImageId primaryId         = imageIds[0];
+            if (tiles != 0 && tiles <= count)
+            {
+                Grid grid;
+                grid.columns      = shape.gridColumns;
+                grid.rows         = shape.gridColumns;
+                grid.outputWidth  = IMAGE_SIZE * shape.gridColumns;
+                grid.outputHeight = IMAGE_SIZE * shape.gridColumns;
+                grid.imageIds     = Array<ImageId>(tiles);
+                std::copy(imageIds.begin(), imageIds.begin() + tiles, grid.imageIds.begin());
+                ok = check(writer->addDerivedImageItem(grid, primaryId), "Writer::addDerivedImageItem()");
+            }
+            ok = ok && check(writer->setPrimaryItem(primaryId), "Writer::setPrimaryItem()");
+        }
+
+        const auto begin = std::chrono::steady_clock::now();
+        ok               = ok && check(writer->finalize(), "Writer::finalize()");
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        result.finalizeSeconds = elapsed.count();
+        result.peakBytes       = allocator.peakSinceReset();
+        result.allocations     = allocator.allocationsSinceReset();
+        result.file.assign(stream->data(), stream->data() + stream->size());
+
+        Writer::Destroy(writer);
+        delete stream;
+        return ok;
+    }
+
+    /// Item data accessors report a too small buffer with BUFFER_SIZE_TOO_SMALL, sample data accessors with
+    /// MEMORY_TOO_SMALL_BUFFER.
+    bool isBufferTooSmall(const ErrorCode error)
+    {
+        return error == ErrorCode::BUFFER_SIZE_TOO_SMALL || error == ErrorCode::MEMORY_TOO_SMALL_BUFFER;
+    }
+
+    template <typename Function>
+    double measureSeconds(const int iterations, Function function)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            function();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        return elapsed.count() / iterations;
+    }
+
+    double megabytes(const std::uint64_t bytes)
+    {
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    }
+
+    bool benchmarkFile(const char* name,
+                       const FileKind kind,
+                       const Shape& shape,
+                       const std::vector<Bytes>& images,
+                       const int iterations,
+                       CountingAllocator& allocator)
+    {
+        const auto runs = static_cast<std::uint64_t>(iterations);
+        WriteResult written;
+        double finalizeSeconds = 0.0;
+        for (int i = 0; i < iterations; ++i)
+        {
+            if (!writeFile(kind, shape, images, allocator, written))
+            {
+                return false;
+            }
+            finalizeSeconds += written.finalizeSeconds;
+        }
+        std::printf("%s: %llu bytes\n", name, static_cast<unsigned long long>(written.file.size()));
+        std::printf("  %-24s %10.3f ms   peak heap %8.2f MB   %llu allocations\n", "Writer::finalize()",
+                    finalizeSeconds / iterations * 1000.0, megabytes(written.peakBytes),
+                    static_cast<unsigned long long>(written.allocations));
+
+        MemoryInputStream stream(written.file);
+        Reader* reader = Reader::Create();
+        bool ok        = true;
+
+        allocator.resetPeak();
+        const double initializeSeconds = measureSeconds(iterations, [&]() {
+            reader->close();
+            ok = ok && check(reader->initialize(&stream), "Reader::initialize()");
+        });
+        std::printf("  %-24s %10.3f ms   peak heap %8.2f MB   %llu allocations\n", "Reader::initialize()",
+                    initializeSeconds * 1000.0, megabytes(allocator.peakSinceReset()),
+                    static_cast<unsigned long long>(allocator.allocationsSinceReset() / runs));
+
+        Bytes buffer;
+        std::uint64_t dataBytes = 0;
+        std::uint64_t dataCount = 0;
+        auto readData           = [&](const std::uint64_t bufferSize, ErrorCode error) {
+            dataBytes += bufferSize;
+            ++dataCount;
+            ok = ok && check(error, "Reader::getItemData()");
+        };
+
+        if (ok && kind == FileKind::COLLECTION)
+        {
+            Array<ImageId> imageIds;
+            ok = check(reader->getItemListByType("hvc1", imageIds), "Reader::getItemListByType()");
+
+            const double readSeconds = measureSeconds(iterations, [&]() {
+                for (const auto& imageId : imageIds)
+                {
+                    std::uint64_t size = buffer.size();
+                    ErrorCode error    = reader->getItemData(imageId, buffer.data(), size);
+                    if (isBufferTooSmall(error))
+                    {
+                        buffer.resize(size);
+                        error = reader->getItemData(imageId, buffer.data(), size);
+                    }
+                    readData(size, error);
+                }
+            });
+            if (ok)
+            {
+                std::printf("  %-24s %10.1f MB/s %8.0f items/s\n", "getItemData()",
+                            megabytes(dataBytes / runs) / readSeconds,
+                            static_cast<double>(dataCount / runs) / readSeconds);
+            }
+        }
+        else if (ok)
+        {
+            Array<TrackInformation> trackInfos;
+            ok = check(reader->getTrackInformations(trackInfos), "Reader::getTrackInformations()");
+
+            const double readSeconds = measureSeconds(iterations, [&]() {
+                for (const auto& trackInfo : trackInfos)
+                {
+                    for (const auto& sample : trackInfo.sampleProperties)
+                    {
+                        std::uint64_t size = buffer.size();
+                        ErrorCode error =
+                            reader->getItemData(trackInfo.trackId, sample.sampleId, buffer.data(), size);
+                        if (isBufferTooSmall(error))
+                        {
+                            buffer.resize(size);
+                            error = reader->getItemData(trackInfo.trackId, sample.sampleId, buffer.data(), size);
+                        }
+                        readData(size, error);
+                    }
+                }
+            });
+            if (ok)
+            {
+                std::printf("  %-24s %10.1f MB/s %8.0f samples/s\n", "sample iteration",
+                            megabytes(dataBytes / runs) / readSeconds,
+                            static_cast<double>(dataCount / runs) / readSeconds);
+            }
+        }
+
+        Reader::Destroy(reader);
+        return ok;
+    }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    Shape shape;
+    shape.items              = argc > 1 ? static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 64;
+    shape.gridColumns        = argc > 2 ? static_cast<std::uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 4;
+    shape.samples            = argc > 3 ? static_cast<std::uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 1000;
+    shape.samplesPerFragment = argc > 4 ? static_cast<std::uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 30;
+    shape.dataSize           = (argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 16) * 1024;
+    const int iterations     = argc > 6 ? std::atoi(argv[6]) : 10;
+    if (shape.items == 0 || shape.samples == 0 || shape.dataSize == 0 || iterations <= 0 ||
+        shape.gridColumns * shape.gridColumns > shape.items)
+    {
+        std::fprintf(stderr,
+                     "Usage: %s [image items] [grid columns] [sequence samples] [samples per fragment] "
+                     "[data size in KB] [iterations]\n"
+                     "Grid columns squared may not exceed the number of image items. Use 0 to skip the grid or the "
+                     "fragmented file.\n",
+                     argv[0]);
+        return 1;
+    }
+
+    CountingAllocator allocator;
+    Reader::SetCustomAllocator(&allocator);
+    Writer::SetCustomAllocator(&allocator);
+
+    // Every item and sample has distinct content, so the writer does not deduplicate any of them.
+    std::vector<Bytes> images;
+    const std::uint32_t imageCount = std::max(shape.items, shape.samples);
+    images.reserve(imageCount);
+    for (std::uint32_t i = 0; i < imageCount; ++i)
+    {
+        images.push_back(makeCodedImage(shape.dataSize, i));
+    }
+
+    std::printf("%u image items, %ux%u grid, %u samples, %u samples per fragment, %llu bytes per image, %d "
+                "iterations\n",
+                shape.items, shape.gridColumns, shape.gridColumns, shape.samples, shape.samplesPerFragment,
+                static_cast<unsigned long long>(shape.dataSize), iterations);
+
+    bool ok = benchmarkFile("image collection", FileKind::COLLECTION, shape, images, iterations, allocator);
+    ok      = ok && benchmarkFile("image sequence", FileKind::SEQUENCE, shape, images, iterations, allocator);
+    if (ok && shape.samplesPerFragment != 0)
+    {
+        ok = benchmarkFile("fragmented image sequence", FileKind::FRAGMENTED, shape, images, iterations, allocator);
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2025 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+/** Micro-benchmark of start code scanning and NAL length field conversion.
+ *  Compares the shared helpers of nalutil.hpp to the byte loops they replaced, on a synthetic HEVC-like byte stream.
+ *  Usage: nal_bench [stream size in MB] [iterations] [mean NAL unit size in KB] */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "nalutil.hpp"
+
+namespace
+{
+    typedef std::vector<std::uint8_t> Bytes;
+
+    /// Synthetic byte stream: 4-byte start codes, 2-byte HEVC NAL headers and random payload with emulation prevention.
+    Bytes makeByteStream(const std::uint64_t size, const std::uint64_t meanNalSize)
+    {
+        std::mt19937 random(1234);
+        std::uniform_int_distribution<std::uint64_t> nalSize(meanNalSize / 2, meanNalSize + meanNalSize / 2);
+        std::uniform_int_distribution<int> byteValue(0, 255);
+
+        Bytes stream;
+        stream.reserve(size + meanNalSize * 2);
+        while (stream.size() < size)
+        {
+            stream.insert(stream.end(), {0, 0, 0, 1, 0x26, 0x01});
+            const std::uint64_t payloadSize = nalSize(random);
+            unsigned int zeros              = 0;
+            for (std::uint64_t i = 0; i < payloadSize; ++i)
+            {
+                // Real payloads contain zero runs, so make zeros more frequent than uniform noise would.
+                std::uint8_t byte = (byteValue(random) < 16) ? 0 : static_cast<std::uint8_t>(byteValue(random));
+                if (zeros == 2 && byte <= 3)
+                {
+                    stream.push_back(3);
+                    zeros = 0;
+                }
+                stream.push_back(byte);
+                zeros = (byte == 0) ? zeros + 1 : 0;
+            }
+            if (zeros != 0)
+            {
+                stream.push_back(0x80);  // rbsp trailing bits
+            }
+        }
+        return stream;
+    }
+
+    /// The byte loop of the former MediaDataBox::findStartCode().
+    std::uint64_t legacyFindStartCode(const Bytes& srcData, const std::uint64_t searchStartPos, std::uint64_t& startCodePos)
+    {
+        std::uint64_t i          = searchStartPos;
+        std::uint64_t len        = 0;
+        bool startCodeFound      = false;
+        const size_t srcDataSize = srcData.size();
+
+        while (i < srcDataSize && !startCodeFound)
+        {
+            const uint8_t byte = srcData[i];
+            if (byte == 0)
+            {
+                ++len;
+            }
+            else if (len > 1 && byte == 1)
+            {
+                ++len;
+                startCodeFound = true;
+            }
+            else
+            {
+                len = 0;
+            }
+            ++i;
+        }
+
+        if (startCodeFound)
+        {
+            startCodePos = i - len;
+        }
+        else
+        {
+            startCodePos = i;
+            len          = 0;
+        }
+        return len;
+    }
+
+    /// The loop of the former HeifReaderImpl::processHevcItemData().
+    void legacyConvertLengthFields(std::uint8_t* memoryBuffer, const std::uint64_t memoryBufferSize)
+    {
+        uint32_t outputOffset = 0;
+        while (outputOffset < memoryBufferSize)
+        {
+            uint32_t nalLength           = memoryBuffer[outputOffset];
+            memoryBuffer[outputOffset]     = 0;
+            nalLength                      = (nalLength << 8) | memoryBuffer[outputOffset + 1];
+            memoryBuffer[outputOffset + 1] = 0;
+            nalLength                      = (nalLength << 8) | memoryBuffer[outputOffset + 2];
+            memoryBuffer[outputOffset + 2] = 0;
+            nalLength                      = (nalLength << 8) | memoryBuffer[outputOffset + 3];
+            memoryBuffer[outputOffset + 3] = 1;
+            outputOffset += nalLength + 4;
+        }
+    }
+
+    template <typename FindStartCode>
+    std::vector<std::uint64_t> splitNalUnits(const Bytes& stream, FindStartCode findStartCode)
+    {
+        std::vector<std::uint64_t> startCodePositions;
+        std::uint64_t startCodePos = 0;
+        std::uint64_t pos          = 0;
+        std::uint64_t startCodeLen;
+        while ((startCodeLen = findStartCode(stream, pos, startCodePos)) != 0)
+        {
+            startCodePositions.push_back(startCodePos);
+            pos = startCodePos + startCodeLen;
+        }
+        return startCodePositions;
+    }
+
+    Bytes toLengthFields(const Bytes& stream, const std::vector<std::uint64_t>& startCodePositions)
+    {
+        Bytes output(stream);
+        for (std::size_t i = 0; i < startCodePositions.size(); ++i)
+        {
+            const std::uint64_t nalStart = startCodePositions[i] + 4;
+            const std::uint64_t nalEnd =
+                (i + 1 < startCodePositions.size()) ? startCodePositions[i + 1] : std::uint64_t(stream.size());
+            const auto nalLength                = static_cast<std::uint32_t>(nalEnd - nalStart);
+            output[startCodePositions[i]]     = static_cast<std::uint8_t>(nalLength >> 24);
+            output[startCodePositions[i] + 1] = static_cast<std::uint8_t>(nalLength >> 16);
+            output[startCodePositions[i] + 2] = static_cast<std::uint8_t>(nalLength >> 8);
+            output[startCodePositions[i] + 3] = static_cast<std::uint8_t>(nalLength);
+        }
+        return output;
+    }
+
+    template <typename Function>
+    double measureSeconds(const int iterations, Function function)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            function();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        return elapsed.count() / iterations;
+    }
+
+    void report(const char* name, const std::uint64_t bytes, const double legacySeconds, const double newSeconds)
+    {
+        const double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+        std::printf("%-28s legacy %9.1f MB/s   new %9.1f MB/s   speedup %5.2fx\n", name, megabytes / legacySeconds,
+                    megabytes / newSeconds, legacySeconds / newSeconds);
+    }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const std::uint64_t streamSize  = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64) * 1024 * 1024;
+    const int iterations            = argc > 2 ? std::atoi(argv[2]) : 10;
+    const std::uint64_t meanNalSize = (argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 256) * 1024;
+    if (streamSize == 0 || iterations <= 0 || meanNalSize == 0)
+    {
+        std::fprintf(stderr, "Usage: %s [stream size in MB] [iterations] [mean NAL unit size in KB]\n", argv[0]);
+        return 1;
+    }
+
+    const Bytes stream = makeByteStream(streamSize, meanNalSize);
+    std::printf("Byte stream of %llu bytes, %d iterations\n", static_cast<unsigned long long>(stream.size()),
+                iterations);
+
+    auto newFindStartCode = [](const Bytes& data, std::uint64_t pos, std::uint64_t& startCodePos) {
+        return findStartCode(data.data(), data.size(), pos, startCodePos);
+    };
+    const std::vector<std::uint64_t> legacyNalUnits = splitNalUnits(stream, legacyFindStartCode);
+    const std::vector<std::uint64_t> newNalUnits    = splitNalUnits(stream, newFindStartCode);
+    if (legacyNalUnits != newNalUnits)
+    {
+        std::fprintf(stderr, "Start code positions differ\n");
+        return 1;
+    }
+    std::printf("%zu NAL units\n", newNalUnits.size());
+
+    volatile std::size_t sink = 0;
+    const double legacyScan   = measureSeconds(iterations, [&]() {
+        sink = sink + splitNalUnits(stream, legacyFindStartCode).size();
+    });
+    const double newScan      = measureSeconds(iterations, [&]() {
+        sink = sink + splitNalUnits(stream, newFindStartCode).size();
+    });
+    report("start code scan", stream.size(), legacyScan, newScan);
+
+    const Bytes lengthFields = toLengthFields(stream, newNalUnits);
+    Bytes legacyOutput(lengthFields);
+    Bytes newOutput(lengthFields);
+    legacyConvertLengthFields(legacyOutput.data(), legacyOutput.size());
+    if (!convertLengthFieldsToStartCodes(newOutput.data(), newOutput.size()) || legacyOutput != newOutput ||
+        newOutput != stream)
+    {
+        std::fprintf(stderr, "Length field conversion differs\n");
+        return 1;
+    }
+
+    Bytes work(lengthFields.size());
+    const double legacyRewrite = measureSeconds(iterations, [&]() {
+        std::memcpy(work.data(), lengthFields.data(), work.size());
+        legacyConvertLengthFields(work.data(), work.size());
+    });
+    const double newRewrite    = measureSeconds(iterations, [&]() {
+        std::memcpy(work.data(), lengthFields.data(), work.size());
+        sink = sink + convertLengthFieldsToStartCodes(work.data(), work.size());
+    });
+    report("length fields to start codes", work.size(), legacyRewrite, newRewrite);
+
+    return 0;
+}
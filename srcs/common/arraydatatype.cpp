@@ -98,6 +98,7 @@ namespace HEIF
     instance(FourCCToIds);
     instance(SampleGrouping);
     instance(ItemInformation);
+    instance(ItemDataBuffer);
     instance(ItemPropertyInfo);
     instance(SampleAndEntryIds);
     instance(SampleInformation);
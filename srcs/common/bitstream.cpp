@@ -24,6 +24,8 @@ namespace ISOBMFF
 {
     BitStream::BitStream()
         : mStorage()
+        , mView(nullptr)
+        , mViewSize(0)
         , mCurrByte(0)
         , mByteOffset(0)
         , mBitOffset(0)
@@ -33,6 +35,19 @@ namespace ISOBMFF
 
     BitStream::BitStream(Vector<std::uint8_t> strData)
         : mStorage(std::move(strData))
+        , mView(nullptr)
+        , mViewSize(0)
+        , mCurrByte(0)
+        , mByteOffset(0)
+        , mBitOffset(0)
+        , mStorageAllocated(false)
+    {
+    }
+
+    BitStream::BitStream(const std::uint8_t* data, const std::uint64_t size)
+        : mStorage()
+        , mView(data)
+        , mViewSize(size)
         , mCurrByte(0)
         , mByteOffset(0)
         , mBitOffset(0)
@@ -42,6 +57,8 @@ namespace ISOBMFF
 
     BitStream::BitStream(BitStream&& other) noexcept
         : mStorage(std::move(other.mStorage))
+        , mView(other.mView)
+        , mViewSize(other.mViewSize)
         , mCurrByte(other.mCurrByte)
         , mByteOffset(other.mByteOffset)
         , mBitOffset(other.mBitOffset)
@@ -51,6 +68,8 @@ namespace ISOBMFF
         other.mByteOffset       = {};
         other.mBitOffset        = {};
         other.mStorageAllocated = {};
+        other.mView             = nullptr;
+        other.mViewSize         = 0;
         other.mStorage.clear();
     }
 
@@ -61,6 +80,8 @@ namespace ISOBMFF
         mBitOffset        = other.mBitOffset;
         mStorageAllocated = other.mStorageAllocated;
         mStorage          = std::move(other.mStorage);
+        mView             = other.mView;
+        mViewSize         = other.mViewSize;
         return *this;
     }
 
@@ -89,24 +110,59 @@ namespace ISOBMFF
 
     std::uint64_t BitStream::getSize() const
     {
-        return mStorage.size();
+        return mView ? mViewSize : mStorage.size();
     }
 
     void BitStream::setSize(const std::uint64_t newSize)
     {
+        detachView();
         mStorage.resize(newSize);
     }
 
     const Vector<std::uint8_t>& BitStream::getStorage() const
     {
+        if (mView)
+        {
+            throw LogicError("BitStream::getStorage called for a view");
+        }
         return mStorage;
     }
 
     Vector<std::uint8_t>& BitStream::getStorage()
     {
+        detachView();
         return mStorage;
     }
 
+    const std::uint8_t* BitStream::getData() const
+    {
+        return mView ? mView : mStorage.data();
+    }
+
+    bool BitStream::isView() const
+    {
+        return mView != nullptr;
+    }
+
+    std::uint8_t BitStream::byteAt(const std::uint64_t offset) const
+    {
+        if (offset >= getSize())
+        {
+            throw std::out_of_range("BitStream::byteAt trying to read outside of the bitstream");
+        }
+        return getData()[offset];
+    }
+
+    void BitStream::detachView()
+    {
+        if (mView)
+        {
+            mStorage.assign(mView, mView + mViewSize);
+            mView     = nullptr;
+            mViewSize = 0;
+        }
+    }
+
     void BitStream::reset()
     {
         mCurrByte   = 0;
@@ -117,6 +173,8 @@ namespace ISOBMFF
     void BitStream::clear()
     {
         mStorage.clear();
+        mView     = nullptr;
+        mViewSize = 0;
     }
 
     void BitStream::skipBytes(const std::uint64_t count)
@@ -126,26 +184,35 @@ namespace ISOBMFF
 
     void BitStream::setByte(const std::uint64_t offset, const std::uint8_t byte)
     {
+        detachView();
         mStorage.at(offset) = byte;
     }
 
+    void BitStream::setBytes(const std::uint64_t offset, const std::uint64_t value, const std::uint32_t byteCount)
+    {
+        detachView();
+        for (std::uint32_t i = 0; i < byteCount; ++i)
+        {
+            mStorage.at(offset + i) = static_cast<std::uint8_t>(value >> ((byteCount - 1 - i) * 8));
+        }
+    }
+
     std::uint8_t BitStream::getByte(const std::uint64_t offset) const
     {
-        return mStorage.at(offset);
+        return byteAt(offset);
     }
 
     std::uint64_t BitStream::numBytesLeft() const
     {
-        return mStorage.size() - mByteOffset;
+        return getSize() - mByteOffset;
     }
     void BitStream::extract(const std::uint64_t begin, const std::uint64_t end, BitStream& dest) const
     {
         dest.clear();
         dest.reset();
-        if (begin <= mStorage.size() && end <= mStorage.size() && begin <= end)
+        if (begin <= getSize() && end <= getSize() && begin <= end)
         {
-            dest.mStorage.insert(dest.mStorage.begin(), mStorage.begin() + static_cast<std::int64_t>(begin),
-                                 mStorage.begin() + static_cast<std::int64_t>(end));
+            dest.mStorage.insert(dest.mStorage.begin(), getData() + begin, getData() + end);
         }
         else
         {
@@ -153,25 +220,38 @@ namespace ISOBMFF
         }
     }
 
+    BitStream BitStream::subStream(const std::uint64_t begin, const std::uint64_t end) const
+    {
+        if (begin <= getSize() && end <= getSize() && begin <= end)
+        {
+            return BitStream(getData() + begin, end - begin);
+        }
+        throw RuntimeError("BitStream::subStream range is outside of the stream");
+    }
+
     void BitStream::writeBitStream(const BitStream& bitStr)
     {
-        mStorage.insert(mStorage.end(), bitStr.mStorage.begin(), bitStr.mStorage.end());
+        detachView();
+        mStorage.insert(mStorage.end(), bitStr.getData(), bitStr.getData() + bitStr.getSize());
     }
 
 
     void BitStream::write8Bits(const std::uint8_t bits)
     {
+        detachView();
         mStorage.push_back(bits);
     }
 
     void BitStream::write16Bits(const std::uint16_t bits)
     {
+        detachView();
         mStorage.push_back(static_cast<uint8_t>((bits >> 8) & 0xff));
         mStorage.push_back(static_cast<uint8_t>((bits) &0xff));
     }
 
     void BitStream::write24Bits(const std::uint32_t bits)
     {
+        detachView();
         mStorage.push_back(static_cast<uint8_t>((bits >> 16) & 0xff));
         mStorage.push_back(static_cast<uint8_t>((bits >> 8) & 0xff));
         mStorage.push_back(static_cast<uint8_t>((bits) &0xff));
@@ -179,6 +259,7 @@ namespace ISOBMFF
 
     void BitStream::write32Bits(const std::uint32_t bits)
     {
+        detachView();
         mStorage.push_back(static_cast<uint8_t>((bits >> 24) & 0xff));
         mStorage.push_back(static_cast<uint8_t>((bits >> 16) & 0xff));
         mStorage.push_back(static_cast<uint8_t>((bits >> 8) & 0xff));
@@ -187,6 +268,7 @@ namespace ISOBMFF
 
     void BitStream::write64Bits(const std::uint64_t bits)
     {
+        detachView();
         mStorage.push_back(static_cast<uint8_t>((bits >> 56) & 0xff));
         mStorage.push_back(static_cast<uint8_t>((bits >> 48) & 0xff));
         mStorage.push_back(static_cast<uint8_t>((bits >> 40) & 0xff));
@@ -201,12 +283,14 @@ namespace ISOBMFF
                                     const std::uint64_t len,
                                     const std::uint64_t srcOffset)
     {
+        detachView();
         mStorage.insert(mStorage.end(), bits.begin() + static_cast<std::int64_t>(srcOffset),
                         bits.begin() + static_cast<std::int64_t>(srcOffset + len));
     }
 
     void BitStream::writeBits(std::uint64_t bits, std::uint32_t len)
     {
+        detachView();
         if (len == 0)
         {
             logWarning() << "BitStream::writeBits called for zero-length bit sequence." << std::endl;
@@ -240,6 +324,7 @@ namespace ISOBMFF
 
     void BitStream::writeString(const String& srcString)
     {
+        detachView();
         if (srcString.length() == 0)
         {
             logWarning() << "BitStream::writeString called for zero-length string." << std::endl;
@@ -253,6 +338,7 @@ namespace ISOBMFF
 
     void BitStream::writeZeroTerminatedString(const String& srcString)
     {
+        detachView();
         for (const auto character : srcString)
         {
             mStorage.push_back(static_cast<unsigned char>(character));
@@ -281,61 +367,61 @@ namespace ISOBMFF
 
     std::uint8_t BitStream::read8Bits()
     {
-        const std::uint8_t ret = mStorage.at(mByteOffset);
+        const std::uint8_t ret = byteAt(mByteOffset);
         ++mByteOffset;
         return ret;
     }
 
     std::uint16_t BitStream::read16Bits()
     {
-        std::uint16_t ret = mStorage.at(mByteOffset);
+        std::uint16_t ret = byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
         return ret;
     }
 
     std::uint32_t BitStream::read24Bits()
     {
-        unsigned int ret = mStorage.at(mByteOffset);
+        unsigned int ret = byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
         return ret;
     }
 
     std::uint32_t BitStream::read32Bits()
     {
-        unsigned int ret = mStorage.at(mByteOffset);
+        unsigned int ret = byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
         return ret;
     }
 
     std::uint64_t BitStream::read64Bits()
     {
-        unsigned long long int ret = mStorage.at(mByteOffset);
+        unsigned long long int ret = byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
-        ret = (ret << 8) | mStorage.at(mByteOffset);
+        ret = (ret << 8) | byteAt(mByteOffset);
         mByteOffset++;
 
         return ret;
@@ -343,10 +429,9 @@ namespace ISOBMFF
 
     void BitStream::read8BitsArray(Vector<std::uint8_t>& bits, const std::uint64_t len)
     {
-        if (static_cast<std::size_t>(mByteOffset + len) <= mStorage.size())
+        if (static_cast<std::size_t>(mByteOffset + len) <= getSize())
         {
-            bits.insert(bits.end(), mStorage.begin() + static_cast<std::int64_t>(mByteOffset),
-                        mStorage.begin() + static_cast<std::int64_t>(mByteOffset + len));
+            bits.insert(bits.end(), getData() + mByteOffset, getData() + mByteOffset + len);
             mByteOffset += len;
         }
         else
@@ -357,9 +442,9 @@ namespace ISOBMFF
 
     void BitStream::readByteArrayToBuffer(char* buffer, const std::uint64_t len)
     {
-        if (static_cast<std::size_t>(mByteOffset + len) <= mStorage.size())
+        if (static_cast<std::size_t>(mByteOffset + len) <= getSize())
         {
-            std::memcpy(buffer, mStorage.data() + mByteOffset, len);
+            std::memcpy(buffer, getData() + mByteOffset, len);
             mByteOffset += len;
         }
         else
@@ -380,28 +465,28 @@ namespace ISOBMFF
 
         if (numBitsLeftInByte >= len)
         {
-            returnBits = static_cast<unsigned int>((mStorage).at(mByteOffset) >> (numBitsLeftInByte - len)) &
+            returnBits = static_cast<unsigned int>(byteAt(mByteOffset) >> (numBitsLeftInByte - len)) &
                          static_cast<unsigned int>((1 << len) - 1);
             mBitOffset += static_cast<unsigned int>(len);
         }
         else
         {
             std::uint32_t numBitsToGo = len - numBitsLeftInByte;
-            returnBits = (mStorage).at(mByteOffset) & ((static_cast<unsigned int>(1) << numBitsLeftInByte) - 1);
+            returnBits = byteAt(mByteOffset) & ((static_cast<unsigned int>(1) << numBitsLeftInByte) - 1);
             mByteOffset++;
             mBitOffset = 0;
             while (numBitsToGo > 0)
             {
                 if (numBitsToGo >= 8)
                 {
-                    returnBits = (returnBits << 8) | (mStorage).at(mByteOffset);
+                    returnBits = (returnBits << 8) | byteAt(mByteOffset);
                     mByteOffset++;
                     numBitsToGo -= 8;
                 }
                 else
                 {
                     returnBits = (returnBits << numBitsToGo) |
-                                 (static_cast<unsigned int>((mStorage).at(mByteOffset) >> (8 - numBitsToGo)) &
+                                 (static_cast<unsigned int>(byteAt(mByteOffset) >> (8 - numBitsToGo)) &
                                   ((static_cast<unsigned int>(1) << numBitsToGo) - 1));
                     mBitOffset += static_cast<unsigned int>(numBitsToGo);
                     numBitsToGo = 0;
@@ -443,7 +528,7 @@ namespace ISOBMFF
         std::uint8_t currChar = 0xff;
         dstString.clear();
 
-        while (mByteOffset < mStorage.size())
+        while (mByteOffset < getSize())
         {
             currChar = read8Bits();
             if (currChar != 0)
@@ -509,8 +594,7 @@ namespace ISOBMFF
             throw RuntimeError("BitStream::readSubBoxBitStream trying to read too small box");
         }
 
-        BitStream subBitstr;
-        extract(getPos(), getPos() + boxSize, subBitstr);
+        BitStream subBitstr = subStream(getPos(), getPos() + boxSize);
         mByteOffset += boxSize;
 
         return subBitstr;
@@ -29,7 +29,11 @@ namespace ISOBMFF
     {
     public:
         BitStream();
+        /// Adopt strData as the storage of the bitstream, without copying it.
         BitStream(Vector<std::uint8_t> strData);
+        /** Construct a read-only view of size bytes at data, without copying them. The data must outlive the
+         *  bitstream and its sub-streams. Writing to a view first copies the viewed bytes to own storage. */
+        BitStream(const std::uint8_t* data, std::uint64_t size);
         BitStream(const BitStream&) = default;
         BitStream& operator=(const BitStream&) = default;
         BitStream(BitStream&&) noexcept;
@@ -56,12 +60,18 @@ namespace ISOBMFF
          *  @param newSize Byte size of the bitstream */
         void setSize(std::uint64_t newSize);
 
-        /// @return Reference to the stored data inside the bitstream
+        /// @return Reference to the stored data inside the bitstream. Not available for a view.
         const Vector<std::uint8_t>& getStorage() const;
 
-        /// @return Reference to the stored data inside the bitstream
+        /// @return Reference to the stored data inside the bitstream. A view copies the viewed bytes to own storage.
         Vector<std::uint8_t>& getStorage();
 
+        /// @return Pointer to the data of the bitstream, owned or viewed.
+        const std::uint8_t* getData() const;
+
+        /// @return True if the bitstream is a read-only view of data it does not own.
+        bool isView() const;
+
         /// @brief Reset any bit and byte offsets used in the bitstream access
         void reset();
 
@@ -77,6 +87,12 @@ namespace ISOBMFF
          *  @param byte   Value to be set. */
         void setByte(std::uint64_t offset, std::uint8_t byte);
 
+        /** @brief Overwrites an unsigned big-endian value in the bitstream data storage.
+         *  @param offset    Byte offset location of the value in the bitstream data storage.
+         *  @param value     Value to be set.
+         *  @param byteCount Byte size of the value field. */
+        void setBytes(std::uint64_t offset, std::uint64_t value, std::uint32_t byteCount);
+
         /** @brief Get a byte value from the bitstream data storage.
          *  @param offset Byte offset location in the bitstream data storage.
          *  @return Byte value as an unsigned integer. */
@@ -184,6 +200,7 @@ namespace ISOBMFF
 
         /** Get BitStream of a sub Box. First 32 bits read defines size, next 32 bits boxType.
          * Read pointer of BitStream is incremented by size.
+         * The sub-box BitStream is a view, valid as long as the data of this bitstream is not modified or released.
          * @param boxType [out] Type of the read sub-box
          * @return Sub-box BitStream */
         BitStream readSubBoxBitStream(FourCCInt& boxType);
@@ -199,13 +216,34 @@ namespace ISOBMFF
          * @param [out] dest Destination BitStream. */
         void extract(std::uint64_t begin, std::uint64_t end, BitStream& dest) const;
 
+        /**
+         * Get a view of part of BitStream, without copying it.
+         * The view is valid as long as the data of this bitstream is not modified or released.
+         *
+         * @param [in] begin Start offset from the bitstream begin
+         * @param [in] end   End offset from the bitstream begin
+         * @return View BitStream. */
+        BitStream subStream(std::uint64_t begin, std::uint64_t end) const;
+
         /// @return True if current bit offset location inside a byte is zero, false otherwise.
         bool isByteAligned() const;
 
     private:
+        /// @return Byte at offset of the owned or viewed data; throws std::out_of_range if outside of it.
+        std::uint8_t byteAt(std::uint64_t offset) const;
+
+        /// @brief Copy the viewed bytes to own storage so that the bitstream can be modified.
+        void detachView();
+
         /// @brief Bitstream data storage as a vector of unsigned integers
         Vector<std::uint8_t> mStorage;
 
+        /// @brief Viewed data when the bitstream does not own its data, otherwise nullptr.
+        const std::uint8_t* mView;
+
+        /// @brief Byte size of the viewed data.
+        std::uint64_t mViewSize;
+
         /// @brief The value of the current processed byte
         unsigned int mCurrByte;
 
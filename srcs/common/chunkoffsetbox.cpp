@@ -21,6 +21,7 @@
 ChunkOffsetBox::ChunkOffsetBox()
     : FullBox("stco", 0, 0)
     , mChunkOffsets()
+    , mChunkOffsetsLocation(0)
 {
 }
 
@@ -53,6 +54,7 @@ void ChunkOffsetBox::writeBox(ISOBMFF::BitStream& bitstr) const
     writeFullBoxHeader(bitstr);
 
     bitstr.write32Bits(static_cast<uint32_t>(mChunkOffsets.size()));
+    mChunkOffsetsLocation = bitstr.getSize();
     if (getType() == "stco")
     {
         for (unsigned long chunkOffset : mChunkOffsets)
@@ -72,6 +74,17 @@ void ChunkOffsetBox::writeBox(ISOBMFF::BitStream& bitstr) const
     updateSize(bitstr);
 }
 
+void ChunkOffsetBox::updateSerializedChunkOffsets(ISOBMFF::BitStream& bitstr) const
+{
+    const std::uint32_t fieldSize = (getType() == "stco") ? 4 : 8;
+    std::uint64_t location        = mChunkOffsetsLocation;
+    for (const auto chunkOffset : mChunkOffsets)
+    {
+        bitstr.setBytes(location, chunkOffset, fieldSize);
+        location += fieldSize;
+    }
+}
+
 void ChunkOffsetBox::parseBox(ISOBMFF::BitStream& bitstr)
 {
     //  First parse the box header
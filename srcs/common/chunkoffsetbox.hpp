@@ -50,9 +50,16 @@ public:
      *  @param [in]  bitstr Bitstream that contains the box data */
     void parseBox(ISOBMFF::BitStream& bitstr) override;
 
+    /** @brief Rewrites the chunk offset values in place to the bitstream the box was last serialized to with
+     *  writeBox(). Box type and size are not changed, so offsets modified after writeBox() must still fit the type.
+     *  @param [in,out] bitstr Bitstream that contains the serialized box data */
+    void updateSerializedChunkOffsets(ISOBMFF::BitStream& bitstr) const;
+
 private:
     /// @brief Chunk offset values. 'stco' uses just first 32 bits, 'co64' all 64 bits.
     Vector<std::uint64_t> mChunkOffsets;
+    /// @brief Byte position of the first chunk offset value in the bitstream of the last writeBox() call.
+    mutable std::uint64_t mChunkOffsetsLocation;
 };
 
 #endif /* end of include guard: CHUNKOFFSETBOX_HPP */
@@ -19,6 +19,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace HEIF
@@ -179,6 +180,9 @@ using Set = std::set<T, Compare, Allocator<T>>;
 template <typename K, typename V, typename Compare = std::less<K>>
 using Map = std::map<K, V, Compare, Allocator<std::pair<const K, V>>>;
 
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+using UnorderedMap = std::unordered_map<K, V, Hash, KeyEqual, Allocator<std::pair<const K, V>>>;
+
 typedef std::basic_istringstream<char, std::char_traits<char>, Allocator<char>> IStringStream;
 typedef std::basic_ostringstream<char, std::char_traits<char>, Allocator<char>> OStringStream;
 
@@ -423,6 +423,35 @@ bool DecodePts::unravel()
     return success;
 }
 
+bool DecodePts::unravelSpan()
+{
+    const Vector<std::uint32_t> mediaDtsTS = mTimeToSampleBox->getSampleTimes();
+    Vector<std::int64_t> ptsDelta;
+    if (mCompositionOffsetBox != nullptr)
+    {
+        ptsDelta = mCompositionOffsetBox->getSampleCompositionOffsets();
+        if (ptsDelta.size() != mediaDtsTS.size())
+        {
+            return false;
+        }
+    }
+
+    if (mediaDtsTS.empty())
+    {
+        mMovieOffset = 0;
+        return true;
+    }
+
+    std::int64_t lastPts = std::numeric_limits<std::int64_t>::min();
+    for (std::size_t index = 0; index < mediaDtsTS.size(); ++index)
+    {
+        const std::int64_t pts = std::int64_t(mediaDtsTS[index]) + (ptsDelta.empty() ? 0 : ptsDelta[index]);
+        lastPts                = std::max(lastPts, pts);
+    }
+    mMovieOffset = static_cast<std::uint64_t>(lastPts) + lastSampleDuration();
+    return true;
+}
+
 void DecodePts::unravelTrackRun()
 {
     // First fetch the decode time stamps
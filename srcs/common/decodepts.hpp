@@ -76,6 +76,15 @@ public:
      */
     bool unravel();
 
+    /**
+     * @brief Determine the span like unravel() does, without generating the presentation timestamps.
+     * @pre mTimeToSampleBox has been set
+     * @pre mCompositionOffsetBox has been set if CompositionOffsetBox is present
+     * @pre No EditListBox has been set
+     * @return true if succeeded, false if unravel() would fail
+     */
+    bool unravelSpan();
+
     /**
      * @brief Generate presentation timestamps
      * @pre TrackRunBox has been set
@@ -26,6 +26,7 @@ ItemInfoBox::ItemInfoBox(const uint8_t version)
     : FullBox("iinf", version, 0)
     , mItemInfoList()
     , mItemIds()
+    , mItemIndex()
 {
 }
 
@@ -36,38 +37,63 @@ const Vector<std::uint32_t>& ItemInfoBox::getItemIds() const
 
 void ItemInfoBox::addItemInfoEntry(const ItemInfoEntry& infoEntry)
 {
+    // The first entry of a duplicated item ID is the one found by lookups.
+    mItemIndex.insert(std::make_pair(infoEntry.getItemID(), mItemInfoList.size()));
     mItemInfoList.push_back(infoEntry);
     mItemIds.push_back(infoEntry.getItemID());
 }
 
-ItemInfoEntry ItemInfoBox::getItemById(const uint32_t itemId) const
+std::size_t ItemInfoBox::findItemIndex(const uint32_t itemId) const
 {
-    for (const auto& item : mItemInfoList)
+    const auto indexIter = mItemIndex.find(itemId);
+    if (indexIter != mItemIndex.end() && indexIter->second < mItemInfoList.size() &&
+        mItemInfoList[indexIter->second].getItemID() == itemId)
     {
-        if (item.getItemID() == itemId)
+        return indexIter->second;
+    }
+
+    // Entries may have been modified through getItemById(), so fall back to a linear search.
+    for (std::size_t index = 0; index < mItemInfoList.size(); ++index)
+    {
+        if (mItemInfoList[index].getItemID() == itemId)
         {
-            return item;
+            return index;
         }
     }
-    throw RuntimeError("Requested ItemInfoEntry not found.");
+    return mItemInfoList.size();
+}
+
+const ItemInfoEntry* ItemInfoBox::findItemById(const uint32_t itemId) const
+{
+    const std::size_t index = findItemIndex(itemId);
+    return index < mItemInfoList.size() ? &mItemInfoList[index] : nullptr;
+}
+
+const ItemInfoEntry& ItemInfoBox::getItemById(const uint32_t itemId) const
+{
+    const ItemInfoEntry* item = findItemById(itemId);
+    if (item == nullptr)
+    {
+        throw RuntimeError("Requested ItemInfoEntry not found.");
+    }
+    return *item;
 }
 
 ItemInfoEntry& ItemInfoBox::getItemById(const uint32_t itemId)
 {
-    for (auto& item : mItemInfoList)
+    const std::size_t index = findItemIndex(itemId);
+    if (index == mItemInfoList.size())
     {
-        if (item.getItemID() == itemId)
-        {
-            return item;
-        }
+        throw RuntimeError("Requested ItemInfoEntry not found.");
     }
-    throw RuntimeError("Requested ItemInfoEntry not found.");
+    return mItemInfoList[index];
 }
 
 void ItemInfoBox::clear()
 {
     mItemInfoList.clear();
     mItemIds.clear();
+    mItemIndex.clear();
 }
 
 void ItemInfoBox::writeBox(ISOBMFF::BitStream& bitstr) const
@@ -115,6 +141,7 @@ void ItemInfoBox::parseBox(ISOBMFF::BitStream& bitstr)
 
     mItemInfoList.reserve(entryCount);
     mItemIds.reserve(entryCount);
+    mItemIndex.reserve(entryCount);
     for (size_t i = 0; i < entryCount; ++i)
     {
         // Extract contained box bitstream and type
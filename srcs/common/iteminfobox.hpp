@@ -60,11 +60,16 @@ public:
      * @return ItemInfoEntry at the desired index */
     ItemInfoEntry* findItemWithType(FourCCInt itemType, unsigned int index = 0);
 
+    /** @brief Find the ItemInfoEntry of an item with a desired itemId
+     * @param [in] itemId ID of an Item
+     * @return Pointer to the ItemInfoEntry with the desired itemId, or nullptr if not found. */
+    const ItemInfoEntry* findItemById(uint32_t itemId) const;
+
     /** @brief Return an ItemInfoEntry of an item with a desired itemId
      * @param [in] itemId ID of an Item
      * @return ItemInfoEntry with the desired itemId
      * @throws Runtime Exception if the requested ItemInfoEntry is not found. */
-    ItemInfoEntry getItemById(uint32_t itemId) const;
+    const ItemInfoEntry& getItemById(uint32_t itemId) const;
 
     /** @brief Return an ItemInfoEntry of an item with a desired itemId
      * @param [in] itemId ID of an Item
@@ -73,8 +78,11 @@ public:
     ItemInfoEntry& getItemById(uint32_t itemId);
 
 private:
-    Vector<ItemInfoEntry> mItemInfoList;  ///< Vector of the ItemInfoEntry Boxes
+    Vector<ItemInfoEntry> mItemInfoList;                 ///< Vector of the ItemInfoEntry Boxes
     Vector<std::uint32_t> mItemIds;
+    UnorderedMap<std::uint32_t, std::size_t> mItemIndex;  ///< Item ID to index of the entry in mItemInfoList
+
+    std::size_t findItemIndex(std::uint32_t itemId) const;  ///< Index of the entry in mItemInfoList, or list size
 };
 
 /** @brief Item Information Entry Box. Extends from FullBox.
@@ -87,6 +87,8 @@ ItemLocationBox::ItemLocationBox()
     , mBaseOffsetSize(4)
     , mIndexSize(0)
     , mItemLocations()
+    , mItemIndex()
+    , mBaseOffsetLocations()
 {
 }
 
@@ -142,6 +144,8 @@ void ItemLocationBox::addLocation(const ItemLocation& itemLoc)
     {
         setVersion(1);
     }
+    // The first entry of a duplicated item ID is the one found by lookups.
+    mItemIndex.insert(std::make_pair(itemLoc.getItemID(), mItemLocations.size()));
     mItemLocations.push_back(itemLoc);
 }
 
@@ -185,6 +189,8 @@ bool ItemLocationBox::setItemDataReferenceIndex(const std::uint32_t itemId, cons
 void ItemLocationBox::writeBox(ISOBMFF::BitStream& bitstr) const
 {
     writeFullBoxHeader(bitstr);
+    mBaseOffsetLocations.clear();
+    mBaseOffsetLocations.reserve(mItemLocations.size());
 
     bitstr.writeBits(mOffsetSize, 4);
     bitstr.writeBits(mLengthSize, 4);
@@ -223,6 +229,7 @@ void ItemLocationBox::writeBox(ISOBMFF::BitStream& bitstr) const
             bitstr.writeBits(static_cast<unsigned int>(itemLoc.getConstructionMethod()), 4);
         }
         bitstr.write16Bits(itemLoc.getDataReferenceIndex());
+        mBaseOffsetLocations.push_back(bitstr.getSize());
         bitstr.writeBits(itemLoc.getBaseOffset(), static_cast<unsigned int>(mBaseOffsetSize * 8));
         bitstr.write16Bits(itemLoc.getExtentCount());
 
@@ -241,6 +248,14 @@ void ItemLocationBox::writeBox(ISOBMFF::BitStream& bitstr) const
     updateSize(bitstr);
 }
 
+void ItemLocationBox::updateSerializedBaseOffsets(ISOBMFF::BitStream& bitstr) const
+{
+    for (std::size_t index = 0; index < mBaseOffsetLocations.size(); ++index)
+    {
+        bitstr.setBytes(mBaseOffsetLocations.at(index), mItemLocations.at(index).getBaseOffset(), mBaseOffsetSize);
+    }
+}
+
 void ItemLocationBox::parseBox(ISOBMFF::BitStream& bitstr)
 {
     unsigned int itemCount = 0;
@@ -327,16 +342,27 @@ const ItemLocationExtent& ItemLocation::getExtent(const unsigned int i) const
     }
 }
 
-ItemLocationVector::const_iterator ItemLocationBox::findItem(const std::uint32_t itemId) const
+std::size_t ItemLocationBox::findItemIndex(const std::uint32_t itemId) const
 {
+    const auto indexIter = mItemIndex.find(itemId);
+    if (indexIter != mItemIndex.end() && indexIter->second < mItemLocations.size() &&
+        mItemLocations[indexIter->second].getItemID() == itemId)
+    {
+        return indexIter->second;
+    }
+
+    // Entries may have been modified through getItemLocations(), so fall back to a linear search.
     auto iter = std::find_if(mItemLocations.cbegin(), mItemLocations.cend(),
                              [itemId](const ItemLocation& itemLocation) { return itemLocation.getItemID() == itemId; });
-    return iter;
+    return static_cast<std::size_t>(iter - mItemLocations.cbegin());
+}
+
+ItemLocationVector::const_iterator ItemLocationBox::findItem(const std::uint32_t itemId) const
+{
+    return mItemLocations.cbegin() + static_cast<std::ptrdiff_t>(findItemIndex(itemId));
 }
 
 ItemLocationVector::iterator ItemLocationBox::findItem(const std::uint32_t itemId)
 {
-    auto iter = std::find_if(mItemLocations.begin(), mItemLocations.end(),
-                             [itemId](const ItemLocation& itemLocation) { return itemLocation.getItemID() == itemId; });
-    return iter;
+    return mItemLocations.begin() + static_cast<std::ptrdiff_t>(findItemIndex(itemId));
 }
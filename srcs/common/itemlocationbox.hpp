@@ -194,13 +194,21 @@ public:
      *  @throws Run-time Exception if an entry with the given item Id is not found. */
     const ItemLocation& getItemLocationForID(unsigned int itemID) const;
 
+    /** @brief Rewrites the base offsets of item location entries in place to the bitstream the box was last serialized
+     *  to with writeBox(). Base offset size is not changed, so the values must still fit it.
+     *  @param [in,out] bitstr Bitstream that contains the serialized box data */
+    void updateSerializedBaseOffsets(ISOBMFF::BitStream& bitstr) const;
+
 private:
     std::uint8_t mOffsetSize;           ///< Offset size {0,4, or 8}
     std::uint8_t mLengthSize;           ///< Length size {0,4, or 8}
     std::uint8_t mBaseOffsetSize;       ///< Base offset size {0,4, or 8}
     std::uint8_t mIndexSize;            ///< Index size {0,4, or 8} and only if version == 1, otherwise reserved
     ItemLocationVector mItemLocations;  ///< Vector of item location entries
+    UnorderedMap<std::uint32_t, std::size_t> mItemIndex;  ///< Item ID to index of the entry in mItemLocations
+    mutable Vector<std::uint64_t> mBaseOffsetLocations;  ///< Byte positions of base offsets of the last writeBox()
 
+    std::size_t findItemIndex(std::uint32_t itemId) const;  ///< Index of the item entry, or mItemLocations.size()
     ItemLocationVector::const_iterator
     findItem(std::uint32_t itemId) const;  ///< Find an item with given itemId and return as a const
     ItemLocationVector::iterator findItem(std::uint32_t itemId);  ///< Find an item with given itemId and return
@@ -17,6 +17,8 @@
 #include <limits>
 #include <stdexcept>
 
+#include "nalutil.hpp"
+
 using namespace std;
 
 MediaDataBox::MediaDataBox()
@@ -185,39 +187,5 @@ std::uint64_t MediaDataBox::findStartCode(const Vector<uint8_t>& srcData,
                                           const std::uint64_t searchStartPos,
                                           std::uint64_t& startCodePos)
 {
-    std::uint64_t i          = searchStartPos;
-    std::uint64_t len        = 0;
-    bool startCodeFound      = false;
-    const size_t srcDataSize = srcData.size();
-
-    while (i < srcDataSize && !startCodeFound)
-    {
-        const uint8_t byte = srcData[i];
-        if (byte == 0)
-        {
-            ++len;
-        }
-        else if (len > 1 && byte == 1)
-        {
-            ++len;
-            startCodeFound = true;
-        }
-        else
-        {
-            len = 0;
-        }
-        ++i;
-    }
-
-    if (startCodeFound)
-    {
-        startCodePos = i - len;
-    }
-    else
-    {
-        startCodePos = i;
-        len          = 0;
-    }
-
-    return len;
+    return ::findStartCode(srcData.data(), srcData.size(), searchStartPos, startCodePos);
 }
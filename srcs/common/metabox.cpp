@@ -208,6 +208,29 @@ void MetaBox::setItemFileOffsetBase(const std::uint64_t baseOffset)
     }
 }
 
+void MetaBox::setItemFileOffsetBases(const Map<std::uint64_t, std::uint64_t>& baseOffsets)
+{
+    auto& itemLocations = mItemLocationBox.getItemLocations();
+    for (auto& iloc : itemLocations)
+    {
+        if (iloc.getConstructionMethod() != ItemLocation::ConstructionMethod::FILE_OFFSET ||
+            iloc.getExtentCount() == 0)
+        {
+            continue;
+        }
+        auto base = baseOffsets.upper_bound(iloc.getExtent(0).mExtentOffset);
+        if (base != baseOffsets.begin())
+        {
+            iloc.setBaseOffset((--base)->second);
+        }
+    }
+}
+
+void MetaBox::updateSerializedItemFileOffsets(ISOBMFF::BitStream& bitstr) const
+{
+    mItemLocationBox.updateSerializedBaseOffsets(bitstr);
+}
+
 const ItemDataBox& MetaBox::getItemDataBox() const
 {
     return mItemDataBox;
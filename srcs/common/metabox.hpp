@@ -226,6 +226,22 @@ public:
      */
     void setItemFileOffsetBase(std::uint64_t baseOffset);
 
+    /**
+     * @brief setItemFileOffsetBases Set base offsets for items with file offset construction method, when item data
+     *                               was written to several 'mdat' boxes.
+     * @param baseOffsets            Base offsets keyed by the smallest extent offset they apply to. An item gets the
+     *                               base offset of the greatest key not exceeding its first extent offset.
+     */
+    void setItemFileOffsetBases(const Map<std::uint64_t, std::uint64_t>& baseOffsets);
+
+    /**
+     * @brief updateSerializedItemFileOffsets Rewrite item base offsets in place to the bitstream the box was last
+     *                                        serialized to with writeBox(). This avoids serializing the box again
+     *                                        after setItemFileOffsetBase(), as base offset fields have a fixed size.
+     * @param bitstr                          Bitstream that contains the serialized box data.
+     */
+    void updateSerializedItemFileOffsets(ISOBMFF::BitStream& bitstr) const;
+
     /**
      * @brief setImageHidden Set image hidden.
      * @param itemId         ID of the image.
@@ -27,6 +27,7 @@ void MovieBox::clear()
 {
     mMovieHeaderBox = {};
     mTracks.clear();
+    mMovieExtendsBox.reset();
 }
 
 MovieHeaderBox& MovieBox::getMovieHeaderBox()
@@ -87,6 +88,11 @@ void MovieBox::writeBox(ISOBMFF::BitStream& bitstr) const
         track->writeBox(bitstr);
     }
 
+    if (mMovieExtendsBox)
+    {
+        mMovieExtendsBox->writeBox(bitstr);
+    }
+
     updateSize(bitstr);
 }
 
@@ -13,6 +13,35 @@
 
 #include "nalutil.hpp"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NALUTIL_USE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NALUTIL_USE_SSE2 1
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+#if defined(NALUTIL_USE_AVX2) || defined(NALUTIL_USE_SSE2)
+    /// @return Index of the lowest set bit of a non-zero mask.
+    inline unsigned int lowestSetBit(const std::uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned int>(index);
+#else
+        return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+    }
+#endif
+}  // namespace
+
 unsigned int findStartCodeLen(const Vector<uint8_t>& data)
 {
     unsigned int i      = 0;
@@ -117,3 +146,100 @@ bool convertByteStreamToRBSP(const Vector<uint8_t>& byteStr, Vector<uint8_t>& ou
     output.insert(output.end(), byteStr.cbegin() + copyStartOffset, byteStr.cend());
     return true;
 }
+
+std::uint64_t findZeroBytePair(const std::uint8_t* data, const std::uint64_t size, std::uint64_t searchStartPos)
+{
+    std::uint64_t i = searchStartPos;
+
+    // Each block compares bytes [i, i + N) and [i + 1, i + N + 1) with zero; a bit set in both masks marks a pair.
+#if defined(NALUTIL_USE_AVX2)
+    const __m256i zero32 = _mm256_setzero_si256();
+    for (; i + 33 <= size; i += 32)
+    {
+        const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i next    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+        const __m256i pairs =
+            _mm256_and_si256(_mm256_cmpeq_epi8(current, zero32), _mm256_cmpeq_epi8(next, zero32));
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(pairs));
+        if (mask != 0)
+        {
+            return i + lowestSetBit(mask);
+        }
+    }
+#endif
+#if defined(NALUTIL_USE_SSE2)
+    const __m128i zero16 = _mm_setzero_si128();
+    for (; i + 17 <= size; i += 16)
+    {
+        const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i next    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+        const __m128i pairs   = _mm_and_si128(_mm_cmpeq_epi8(current, zero16), _mm_cmpeq_epi8(next, zero16));
+        const auto mask       = static_cast<std::uint32_t>(_mm_movemask_epi8(pairs));
+        if (mask != 0)
+        {
+            return i + lowestSetBit(mask);
+        }
+    }
+#endif
+
+    for (; i + 1 < size; ++i)
+    {
+        if (data[i] == 0 && data[i + 1] == 0)
+        {
+            return i;
+        }
+    }
+    return size;
+}
+
+std::uint64_t findStartCode(const std::uint8_t* data,
+                            const std::uint64_t size,
+                            const std::uint64_t searchStartPos,
+                            std::uint64_t& startCodePos)
+{
+    std::uint64_t i = searchStartPos;
+    while ((i = findZeroBytePair(data, size, i)) < size)
+    {
+        // The pair begins the zero run, as a zero byte before it would have formed an earlier pair.
+        std::uint64_t runEnd = i + 2;
+        while (runEnd < size && data[runEnd] == 0)
+        {
+            ++runEnd;
+        }
+        if (runEnd < size && data[runEnd] == 1)
+        {
+            startCodePos = i;
+            return runEnd + 1 - i;
+        }
+        i = runEnd;
+    }
+
+    startCodePos = size;
+    return 0;
+}
+
+bool convertLengthFieldsToStartCodes(std::uint8_t* data, const std::uint64_t size)
+{
+    // Only the length fields are touched, so the cost depends on the number of NAL units rather than their size.
+    std::uint64_t i = 0;
+    while (i < size)
+    {
+        if (size - i < 4)
+        {
+            return false;
+        }
+        const std::uint32_t nalLength = (static_cast<std::uint32_t>(data[i]) << 24) |
+                                        (static_cast<std::uint32_t>(data[i + 1]) << 16) |
+                                        (static_cast<std::uint32_t>(data[i + 2]) << 8) | data[i + 3];
+        if (size - i - 4 < nalLength)
+        {
+            return false;
+        }
+        data[i]     = 0;
+        data[i + 1] = 0;
+        data[i + 2] = 0;
+        data[i + 3] = 1;
+        i += 4 + std::uint64_t(nalLength);
+    }
+    return true;
+}
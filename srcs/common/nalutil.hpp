@@ -14,6 +14,8 @@
 #ifndef NALUTIL_HPP
 #define NALUTIL_HPP
 
+#include <cstdint>
+
 #include "customallocator.hpp"
 
 /**
@@ -35,4 +37,37 @@ unsigned int findStartCodeLen(const Vector<uint8_t>& data);
  */
 bool convertByteStreamToRBSP(const Vector<uint8_t>& byteStr, Vector<uint8_t>& output);
 
+/**
+ * @brief Find the next pair of zero bytes, the prefix of every start code and emulation prevention sequence.
+ * @details Scans 16 or 32 bytes at a time with SSE2 or AVX2 when the build targets them, byte by byte otherwise.
+ * @param data Data to search from
+ * @param size Byte size of data
+ * @param searchStartPos Offset to start searching from
+ * @return Offset of the first of the two zero bytes, or size if there is no such pair.
+ */
+std::uint64_t findZeroBytePair(const std::uint8_t* data, std::uint64_t size, std::uint64_t searchStartPos);
+
+/**
+ * @brief Find the next start code
+ * @details Start code consists of two or more zero bytes (0x00) followed by a one (0x01) byte.
+ * @param data Data to search from
+ * @param size Byte size of data
+ * @param searchStartPos Offset to start searching from
+ * @param [out] startCodePos Offset of the first byte of the start code, or size if a start code is not found.
+ * @return Number of bytes in start code. 0 if a start code is not found.
+ */
+std::uint64_t findStartCode(const std::uint8_t* data,
+                            std::uint64_t size,
+                            std::uint64_t searchStartPos,
+                            std::uint64_t& startCodePos);
+
+/**
+ * Convert NAL units with 4-byte length fields to a byte stream in place, by overwriting each length field with a
+ * 0x00000001 start code.
+ * @param data NAL units with length fields.
+ * @param size Byte size of data.
+ * @return False if a length field is truncated or exceeds the data; NAL units before it have been converted.
+ */
+bool convertLengthFieldsToStartCodes(std::uint8_t* data, std::uint64_t size);
+
 #endif  // NALUTIL_HPP
@@ -141,9 +141,8 @@ void SampleGroupDescriptionBox::parseBox(ISOBMFF::BitStream& bitstr)
             descriptionLength = bitstr.read32Bits();
         }
 
-        BitStream subBitstr;
-        bitstr.extract(bitstr.getPos(), bitstr.getPos() + descriptionLength,
-                       subBitstr);  // extract "sub-bitstream" for entry
+        BitStream subBitstr = bitstr.subStream(bitstr.getPos(),
+                                               bitstr.getPos() + descriptionLength);  // view "sub-bitstream" for entry
         bitstr.skipBytes(descriptionLength);
 
         if (mGroupingType == "refs")
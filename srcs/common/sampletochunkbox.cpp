@@ -13,6 +13,7 @@
 
 #include "sampletochunkbox.hpp"
 
+#include <algorithm>
 #include <limits>
 #include <stdexcept>
 
@@ -21,32 +22,60 @@ using namespace std;
 SampleToChunkBox::SampleToChunkBox()
     : FullBox("stsc", 0, 0)
     , mRunOfChunks()
+    , mDecodedEntries()
+    , mDecodedSampleCount(0)
     , mMaxSampleCount(-1)
 {
 }
 
 bool SampleToChunkBox::getSampleDescriptionIndex(std::uint32_t sampleIndex, std::uint32_t& sampleDescriptionIdx) const
 {
-    if (sampleIndex >= mDecodedEntries.size())
+    const DecodedEntry* entry = findDecodedEntry(sampleIndex);
+    if (entry == nullptr)
     {
         return false;
     }
 
-    sampleDescriptionIdx = mDecodedEntries.at(sampleIndex).sampleDescriptionIndex;
+    sampleDescriptionIdx = entry->sampleDescriptionIndex;
     return true;
 }
 
 bool SampleToChunkBox::getSampleChunkIndex(std::uint32_t sampleIndex, std::uint32_t& chunkIdx) const
 {
-    if (sampleIndex >= mDecodedEntries.size())
+    std::uint32_t firstSampleIdx = 0;
+    return getSampleChunkIndex(sampleIndex, chunkIdx, firstSampleIdx);
+}
+
+bool SampleToChunkBox::getSampleChunkIndex(std::uint32_t sampleIndex,
+                                           std::uint32_t& chunkIdx,
+                                           std::uint32_t& firstSampleIdx) const
+{
+    const DecodedEntry* entry = findDecodedEntry(sampleIndex);
+    if (entry == nullptr)
     {
         return false;
     }
 
-    chunkIdx = mDecodedEntries.at(sampleIndex).chunkIndex;
+    const std::uint64_t chunkInRun = (sampleIndex - entry->firstSampleIndex) / entry->samplesPerChunk;
+    chunkIdx                       = entry->firstChunkIndex + static_cast<std::uint32_t>(chunkInRun);
+    firstSampleIdx = static_cast<std::uint32_t>(entry->firstSampleIndex + chunkInRun * entry->samplesPerChunk);
     return true;
 }
 
+const SampleToChunkBox::DecodedEntry* SampleToChunkBox::findDecodedEntry(std::uint32_t sampleIndex) const
+{
+    if (sampleIndex >= mDecodedSampleCount)
+    {
+        return nullptr;
+    }
+
+    // First run starting after the sample; the sample is in the run before it.
+    const auto next = std::upper_bound(
+        mDecodedEntries.begin(), mDecodedEntries.end(), sampleIndex,
+        [](std::uint32_t index, const DecodedEntry& entry) { return index < entry.firstSampleIndex; });
+    return &*std::prev(next);
+}
+
 void SampleToChunkBox::setSampleCountMaxSafety(int64_t maxSampleCount)
 {
     mMaxSampleCount = maxSampleCount;
@@ -147,6 +176,7 @@ uint32_t SampleToChunkBox::getSampleCountLowerBound(uint32_t chunkEntryCount) co
 void SampleToChunkBox::decodeEntries(std::uint32_t chunkEntryCount)
 {
     mDecodedEntries.clear();
+    mDecodedSampleCount = 0;
 
     if (mRunOfChunks.size() == 0 || chunkEntryCount == 0)
     {
@@ -187,16 +217,18 @@ void SampleToChunkBox::decodeEntries(std::uint32_t chunkEntryCount)
             throw RuntimeError("SampleToChunkBox::parseBox samplesPerChunk is larger than total number of samples");
         }
 
+        if (chunkRepetitions == 0 || samplesPerChunk == 0)
+        {
+            continue;
+        }
+
         DecodedEntry entry;
+        entry.firstSampleIndex       = mDecodedSampleCount;
+        entry.firstChunkIndex        = firstChunk;
+        entry.chunkCount             = chunkRepetitions;
         entry.samplesPerChunk        = samplesPerChunk;
         entry.sampleDescriptionIndex = sampleDescriptionIndex;
-        for (unsigned int i = 0; i < chunkRepetitions; ++i)
-        {
-            entry.chunkIndex = firstChunk + i;
-            for (unsigned int k = 0; k < samplesPerChunk; ++k)
-            {
-                mDecodedEntries.push_back(entry);
-            }
-        }
+        mDecodedEntries.push_back(entry);
+        mDecodedSampleCount += std::uint64_t(chunkRepetitions) * samplesPerChunk;
     }
 }
@@ -39,6 +39,13 @@ public:
      *  @returns true if success */
     bool getSampleChunkIndex(std::uint32_t sampleIndex, std::uint32_t& chunkIdx) const;
 
+    /** @brief Get the sample chunk index and the index of the first sample in that chunk.
+     *  @param [in] sampleIndex Sample index value.
+     *  @param [out] chunkIdx Chunk index of the sample. The index is 1-based.
+     *  @param [out] firstSampleIdx Index of the first sample in the chunk.
+     *  @returns true if success */
+    bool getSampleChunkIndex(std::uint32_t sampleIndex, std::uint32_t& chunkIdx, std::uint32_t& firstSampleIdx) const;
+
     void setSampleCountMaxSafety(int64_t maxSampleCount);
 
     /// Chunk entry data structure
@@ -66,23 +73,30 @@ public:
     */
     uint32_t getSampleCountLowerBound(uint32_t chunkEntryCount) const;
 
-    /** @brief Decodes the representation of ChunkEntries. Each sample wil have an own entry after this.
+    /** @brief Decodes the representation of ChunkEntries. Each run of chunks gets the index of its first sample, so
+     *  that samples are located with a binary search instead of one entry per sample.
      *  @param [in] chunkEntryCount number of total chunk entries from 'stco' */
     void decodeEntries(std::uint32_t chunkEntryCount);
 
 private:
     Vector<ChunkEntry> mRunOfChunks;  ///< Vector that contains the chunk entries
 
-    /// Run-length decoded chunk entries
+    /// Run of chunks with the same number of samples, resolved against the chunk count
     struct DecodedEntry
     {
-        std::uint32_t chunkIndex;
+        std::uint64_t firstSampleIndex;
+        std::uint32_t firstChunkIndex;
+        std::uint32_t chunkCount;
         std::uint32_t samplesPerChunk;
         std::uint32_t sampleDescriptionIndex;
     };
 
-    /// A decoded representation of ChunkEntries. Each sample has an own entry here.
+    /// A decoded representation of ChunkEntries, ascending by first sample. Runs without chunks are left out.
     Vector<DecodedEntry> mDecodedEntries;
+    std::uint64_t mDecodedSampleCount;  ///< Number of samples covered by mDecodedEntries
+
+    /// Decoded run containing the sample, or nullptr if the sample is not covered.
+    const DecodedEntry* findDecodedEntry(std::uint32_t sampleIndex) const;
 
     int64_t mMaxSampleCount;
 };
@@ -0,0 +1,190 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2025 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "heiffiledatatypesinternal.hpp"
+
+#include <algorithm>
+
+namespace HEIF
+{
+    namespace
+    {
+        bool operator==(const CodingConstraints& a, const CodingConstraints& b)
+        {
+            return a.allRefPicsIntra == b.allRefPicsIntra && a.intraPredUsed == b.intraPredUsed &&
+                   a.maxRefPerPic == b.maxRefPerPic;
+        }
+    }  // namespace
+
+    SampleTable::SampleTable()
+        : mCompositionTimeOffsets(1, 0)
+        , mCompositionTimeTSOffsets(1, 0)
+        , mDecodeDependencyOffsets(1, 0)
+    {
+    }
+
+    void SampleTable::reserve(const std::size_t sampleCount)
+    {
+        mSampleIds.reserve(sampleCount);
+        mSegmentIds.reserve(sampleCount);
+        mSampleTypes.reserve(sampleCount);
+        mDurationsTS.reserve(sampleCount);
+        mCompositionOffsetsTs.reserve(sampleCount);
+        mDataOffsets.reserve(sampleCount);
+        mDataLengths.reserve(sampleCount);
+        mSampleFlags.reserve(sampleCount);
+        mEntryIndices.reserve(sampleCount);
+        mCompositionTimeOffsets.reserve(sampleCount + 1);
+        mCompositionTimeTSOffsets.reserve(sampleCount + 1);
+        mDecodeDependencyOffsets.reserve(sampleCount + 1);
+    }
+
+    void SampleTable::push_back(const SampleProperties& sample)
+    {
+        mSampleIds.push_back(sample.sampleId);
+        mSegmentIds.push_back(sample.segmentId);
+        mSampleTypes.push_back(sample.sampleType);
+        mDurationsTS.push_back(sample.sampleDurationTS);
+        mCompositionOffsetsTs.push_back(sample.sampleCompositionOffsetTs);
+        mDataOffsets.push_back(sample.dataOffset);
+        mDataLengths.push_back(sample.dataLength);
+        mSampleFlags.push_back(sample.sampleFlags.flagsAsUInt);
+        mEntryIndices.push_back(findOrAddEntry(sample));
+
+        mCompositionTimes.insert(mCompositionTimes.end(), sample.compositionTimes.begin(),
+                                 sample.compositionTimes.end());
+        mCompositionTimeOffsets.push_back(static_cast<std::uint32_t>(mCompositionTimes.size()));
+        mCompositionTimesTS.insert(mCompositionTimesTS.end(), sample.compositionTimesTS.begin(),
+                                   sample.compositionTimesTS.end());
+        mCompositionTimeTSOffsets.push_back(static_cast<std::uint32_t>(mCompositionTimesTS.size()));
+        mDecodeDependencies.insert(mDecodeDependencies.end(), sample.decodeDependencies.begin(),
+                                   sample.decodeDependencies.end());
+        mDecodeDependencyOffsets.push_back(static_cast<std::uint32_t>(mDecodeDependencies.size()));
+    }
+
+    SampleProperties SampleTable::at(const std::size_t index) const
+    {
+        if (index >= size())
+        {
+            throw std::out_of_range("SampleTable::at");
+        }
+
+        SampleProperties sample;
+        sample.sampleId                  = mSampleIds[index];
+        sample.segmentId                 = mSegmentIds[index];
+        sample.sampleType                = mSampleTypes[index];
+        sample.sampleDurationTS          = mDurationsTS[index];
+        sample.sampleCompositionOffsetTs = mCompositionOffsetsTs[index];
+        sample.dataOffset                = mDataOffsets[index];
+        sample.dataLength                = mDataLengths[index];
+        sample.sampleFlags               = sampleFlags(index);
+
+        const EntryProperties& sampleEntry = entry(index);
+        sample.sampleEntryType             = sampleEntry.sampleEntryType;
+        sample.sampleDescriptionIndex      = sampleEntry.sampleDescriptionIndex;
+        sample.codingConstraints           = sampleEntry.codingConstraints;
+        sample.width                       = sampleEntry.width;
+        sample.height                      = sampleEntry.height;
+        sample.hasClap                     = sampleEntry.hasClap;
+        sample.hasAuxi                     = sampleEntry.hasAuxi;
+
+        const auto times = compositionTimes(index);
+        sample.compositionTimes.assign(times.begin(), times.end());
+        const auto timesTS = compositionTimesTS(index);
+        sample.compositionTimesTS.assign(timesTS.begin(), timesTS.end());
+        const auto dependencies = decodeDependencies(index);
+        sample.decodeDependencies.assign(dependencies.begin(), dependencies.end());
+
+        return sample;
+    }
+
+    std::uint32_t SampleTable::findOrAddEntry(const SampleProperties& sample)
+    {
+        auto matches = [&sample](const EntryProperties& entry) {
+            return entry.sampleEntryType == sample.sampleEntryType &&
+                   entry.sampleDescriptionIndex == sample.sampleDescriptionIndex &&
+                   entry.codingConstraints == sample.codingConstraints && entry.width == sample.width &&
+                   entry.height == sample.height && entry.hasClap == sample.hasClap && entry.hasAuxi == sample.hasAuxi;
+        };
+
+        // Consecutive samples nearly always share the sample description entry, so try the previous one first.
+        if (!mEntryIndices.empty() && matches(mEntries[mEntryIndices.back()]))
+        {
+            return mEntryIndices.back();
+        }
+        for (std::uint32_t index = 0; index < mEntries.size(); ++index)
+        {
+            if (matches(mEntries[index]))
+            {
+                return index;
+            }
+        }
+
+        mEntries.push_back({sample.sampleEntryType, sample.sampleDescriptionIndex, sample.codingConstraints,
+                            sample.width, sample.height, sample.hasClap, sample.hasAuxi});
+        return static_cast<std::uint32_t>(mEntries.size() - 1);
+    }
+
+    template <typename T, typename Map>
+    void SampleTable::appendToPool(Vector<T>& pool, Vector<std::uint32_t>& offsets, const Map& map)
+    {
+        const std::size_t sampleCount = offsets.size() - 1;
+
+        // Count the new values of each sample; negative time implies a hidden sample.
+        Vector<std::uint32_t> added(sampleCount, 0);
+        std::size_t addedTotal = 0;
+        for (const auto& pair : map)
+        {
+            if (pair.first < 0)
+            {
+                continue;
+            }
+            ++added.at(pair.second);
+            ++addedTotal;
+        }
+        if (addedTotal == 0)
+        {
+            return;
+        }
+
+        // Rebuild the pool so that the new values follow the existing values of each sample.
+        Vector<T> newPool(pool.size() + addedTotal);
+        Vector<std::uint32_t> newOffsets(sampleCount + 1, 0);
+        Vector<std::uint32_t> writePos(sampleCount);
+        for (std::size_t index = 0; index < sampleCount; ++index)
+        {
+            const std::uint32_t existing = offsets[index + 1] - offsets[index];
+            std::copy(pool.begin() + offsets[index], pool.begin() + offsets[index + 1],
+                      newPool.begin() + newOffsets[index]);
+            writePos[index]       = newOffsets[index] + existing;
+            newOffsets[index + 1] = newOffsets[index] + existing + added[index];
+        }
+        for (const auto& pair : map)
+        {
+            if (pair.first < 0)
+            {
+                continue;
+            }
+            newPool[writePos[pair.second]++] = static_cast<T>(pair.first);
+        }
+
+        pool.swap(newPool);
+        offsets.swap(newOffsets);
+    }
+
+    void SampleTable::appendCompositionTimes(const DecodePts::PMap& pMap, const DecodePts::PMapTS& pMapTS)
+    {
+        appendToPool(mCompositionTimes, mCompositionTimeOffsets, pMap);
+        appendToPool(mCompositionTimesTS, mCompositionTimeTSOffsets, pMapTS);
+    }
+}  // namespace HEIF
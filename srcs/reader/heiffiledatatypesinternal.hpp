@@ -16,6 +16,8 @@
 
 #include <cstdint>
 #include <set>
+#include <stdexcept>
+#include <utility>
 
 #include "customallocator.hpp"
 #include "decodepts.hpp"
@@ -200,7 +202,6 @@ namespace HEIF
 
     typedef std::pair<SequenceImageId, Timestamp> ItemIdTimestampPair;  ///< Pair of Item/sample ID and timestamp
 
-    typedef Map<SequenceImageIdPair, SampleDescriptionIndex> SampleToParameterSetMap;
     typedef Array<SegmentInformation> SegmentIndex;
 
 
@@ -303,13 +304,225 @@ namespace HEIF
             auxiProperties;  ///< Clean aperture data from sample description entries
     };
 
-    typedef Vector<SampleProperties> SamplePropertyVector;
+    /** @brief Sample information of a track stored as a structure of arrays.
+     *
+     * Per-sample scalar fields are kept in parallel columns. Fields that only depend on the sample description entry
+     * (entry type, dimensions, coding constraints...) are stored once per distinct entry and referenced by index, and
+     * the variable length lists (composition times, decode dependencies) share one pool per field with an offset
+     * column. at() materializes a SampleProperties for callers which need the whole record. */
+    class SampleTable
+    {
+    public:
+        /** @brief Read-only view to a contiguous run of values inside a SampleTable pool. */
+        template <typename T>
+        class Range
+        {
+        public:
+            Range(const T* begin, const T* end)
+                : mBegin(begin)
+                , mEnd(end)
+            {
+            }
+            const T* begin() const
+            {
+                return mBegin;
+            }
+            const T* end() const
+            {
+                return mEnd;
+            }
+            std::size_t size() const
+            {
+                return static_cast<std::size_t>(mEnd - mBegin);
+            }
+            bool empty() const
+            {
+                return mBegin == mEnd;
+            }
+            const T& operator[](std::size_t index) const
+            {
+                return mBegin[index];
+            }
+            const T& at(std::size_t index) const
+            {
+                if (index >= size())
+                {
+                    throw std::out_of_range("SampleTable::Range::at");
+                }
+                return mBegin[index];
+            }
+
+        private:
+            const T* mBegin;
+            const T* mEnd;
+        };
+
+        SampleTable();
+
+        void reserve(std::size_t sampleCount);
+        void push_back(const SampleProperties& sample);
+
+        std::size_t size() const
+        {
+            return mSampleIds.size();
+        }
+        bool empty() const
+        {
+            return mSampleIds.empty();
+        }
+
+        /// Materializes the complete properties of the sample at index. Throws std::out_of_range on a bad index.
+        SampleProperties at(std::size_t index) const;
+
+        SequenceImageId sampleId(std::size_t index) const
+        {
+            return mSampleIds[index];
+        }
+        SegmentId segmentId(std::size_t index) const
+        {
+            return mSegmentIds[index];
+        }
+        SampleType sampleType(std::size_t index) const
+        {
+            return mSampleTypes[index];
+        }
+        std::uint32_t sampleDurationTS(std::size_t index) const
+        {
+            return mDurationsTS[index];
+        }
+        std::int64_t sampleCompositionOffsetTs(std::size_t index) const
+        {
+            return mCompositionOffsetsTs[index];
+        }
+        std::uint64_t dataOffset(std::size_t index) const
+        {
+            return mDataOffsets[index];
+        }
+        std::uint32_t dataLength(std::size_t index) const
+        {
+            return mDataLengths[index];
+        }
+        SampleFlags sampleFlags(std::size_t index) const
+        {
+            SampleFlags flags;
+            flags.flagsAsUInt = mSampleFlags[index];
+            return flags;
+        }
+
+        FourCCInt sampleEntryType(std::size_t index) const
+        {
+            return entry(index).sampleEntryType;
+        }
+        SampleDescriptionIndex sampleDescriptionIndex(std::size_t index) const
+        {
+            return entry(index).sampleDescriptionIndex;
+        }
+        const CodingConstraints& codingConstraints(std::size_t index) const
+        {
+            return entry(index).codingConstraints;
+        }
+        std::uint32_t width(std::size_t index) const
+        {
+            return entry(index).width;
+        }
+        std::uint32_t height(std::size_t index) const
+        {
+            return entry(index).height;
+        }
+        bool hasClap(std::size_t index) const
+        {
+            return entry(index).hasClap;
+        }
+        bool hasAuxi(std::size_t index) const
+        {
+            return entry(index).hasAuxi;
+        }
+
+        Range<std::int64_t> compositionTimes(std::size_t index) const
+        {
+            return range(mCompositionTimes, mCompositionTimeOffsets, index);
+        }
+        Range<std::uint64_t> compositionTimesTS(std::size_t index) const
+        {
+            return range(mCompositionTimesTS, mCompositionTimeTSOffsets, index);
+        }
+        Range<SequenceImageId> decodeDependencies(std::size_t index) const
+        {
+            return range(mDecodeDependencies, mDecodeDependencyOffsets, index);
+        }
+
+        void setSampleType(std::size_t index, SampleType sampleType)
+        {
+            mSampleTypes.at(index) = sampleType;
+        }
+        void setSampleCompositionOffsetTs(std::size_t index, std::int64_t offset)
+        {
+            mCompositionOffsetsTs.at(index) = offset;
+        }
+        void setSampleFlags(std::size_t index, SampleFlags sampleFlags)
+        {
+            mSampleFlags.at(index) = sampleFlags.flagsAsUInt;
+        }
+
+        /** Appends the non-negative presentation times of the maps to the composition times of the samples they
+         *  refer to. Values of the map are indices to this table. */
+        void appendCompositionTimes(const DecodePts::PMap& pMap, const DecodePts::PMapTS& pMapTS);
+
+    private:
+        /// Sample properties which are shared by every sample using the same sample description entry
+        struct EntryProperties
+        {
+            FourCCInt sampleEntryType;
+            SampleDescriptionIndex sampleDescriptionIndex;
+            CodingConstraints codingConstraints;
+            std::uint32_t width;
+            std::uint32_t height;
+            bool hasClap;
+            bool hasAuxi;
+        };
+
+        const EntryProperties& entry(std::size_t index) const
+        {
+            return mEntries[mEntryIndices[index]];
+        }
+
+        template <typename T>
+        static Range<T> range(const Vector<T>& pool, const Vector<std::uint32_t>& offsets, std::size_t index)
+        {
+            return Range<T>(pool.data() + offsets[index], pool.data() + offsets[index + 1]);
+        }
+
+        std::uint32_t findOrAddEntry(const SampleProperties& sample);
+
+        template <typename T, typename Map>
+        static void appendToPool(Vector<T>& pool, Vector<std::uint32_t>& offsets, const Map& map);
+
+        Vector<SequenceImageId> mSampleIds;
+        Vector<SegmentId> mSegmentIds;
+        Vector<SampleType> mSampleTypes;
+        Vector<std::uint32_t> mDurationsTS;
+        Vector<std::int64_t> mCompositionOffsetsTs;
+        Vector<std::uint64_t> mDataOffsets;
+        Vector<std::uint32_t> mDataLengths;
+        Vector<std::uint32_t> mSampleFlags;
+        Vector<std::uint32_t> mEntryIndices;
+
+        Vector<EntryProperties> mEntries;
+
+        // Pools of the variable length fields. Values of sample i are [offsets[i], offsets[i + 1]) of the pool.
+        Vector<std::int64_t> mCompositionTimes;
+        Vector<std::uint32_t> mCompositionTimeOffsets;
+        Vector<std::uint64_t> mCompositionTimesTS;
+        Vector<std::uint32_t> mCompositionTimeTSOffsets;
+        Vector<SequenceImageId> mDecodeDependencies;
+        Vector<std::uint32_t> mDecodeDependencyOffsets;
+    };
 
     /// Information about samples of a track in a segment.
     struct TrackInfoInSegment
     {
         SequenceImageId itemIdBase;
-        SamplePropertyVector samples;  ///< Information about each sample in the TrackBox
+        SampleTable samples;  ///< Information about each sample in the TrackBox
 
         DecodePts::PresentationTimeTS durationTS    = 0;  ///< Track duration in time scale units, from TrackHeaderBox
         DecodePts::PresentationTimeTS earliestPTSTS = 0;  ///< Time of the first sample in time scale units
@@ -319,8 +532,6 @@ namespace HEIF
         some derived value upon first use and the incremented by trackrun duration when one is read. */
         DecodePts::PresentationTimeTS nextPTSTS = 0;
 
-        WriteOnceMap<SequenceImageId, FourCCInt> decoderCodeTypeMap;  ///< Extracted decoder code types
-
         DecodePts::PMap pMap;      ///< Display timestamps, from edit list
         DecodePts::PMapTS pMapTS;  ///< Display timestamps in time scale units, from edit list
 
@@ -351,13 +562,15 @@ namespace HEIF
         SegmentTypeBox styp;  ///< Segment Type Box for later information retrieval
 
         Map<SequenceId, TrackInfoInSegment> trackInfos;
-
-        SampleToParameterSetMap sampleToParameterSetMap;  ///< Map from every sample to parameter set map entry
     };
 
     typedef Map<SegmentId, SegmentProperties> SegmentPropertiesMap;
     typedef Map<Sequence, SegmentId> SequenceToSegmentMap;
 
+    /// Segments containing samples of a track, keyed by the first sample id of the track in the segment and the first
+    /// sequence number of the segment.
+    typedef Map<std::pair<SequenceImageId, Sequence>, SegmentId> SampleIdToSegmentMap;
+
     /** @brief Overall File Property definition which contains file's properties.*/
     struct FileInformationInternal
     {
@@ -371,6 +584,7 @@ namespace HEIF
         SegmentIndex segmentIndex;
         SegmentPropertiesMap segmentPropertiesMap;
         SequenceToSegmentMap sequenceToSegment;
+        Map<SequenceId, SampleIdToSegmentMap> sampleIdToSegment;  ///< Per track, for segmentIdOf()
     };
 }  // namespace HEIF
 
@@ -17,6 +17,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <limits>
 
 #include "accessibilitytext.hpp"
 #include "auxiliarytypeproperty.hpp"
@@ -84,6 +85,18 @@ namespace HEIF
         return ErrorCode::OK;
     }
 
+    ErrorCode HeifReaderImpl::getFileInformation(const FileInformation*& fileInfo) const
+    {
+        if (isInitialized() != ErrorCode::OK)
+        {
+            return ErrorCode::UNINITIALIZED;
+        }
+
+        fileInfo = &mFileInformation;
+
+        return ErrorCode::OK;
+    }
+
     ErrorCode HeifReaderImpl::getMajorBrand(FourCC& majorBrand) const
     {
         if (isInitialized() != ErrorCode::OK)
@@ -190,12 +203,13 @@ namespace HEIF
                                        uint32_t& width) const
     {
         ErrorCode error;
-        SampleProperties sampleInfo;
-        if ((error = getSampleInfo(sequenceId, itemId, sampleInfo)) != ErrorCode::OK)
+        const SampleTable* sampleTable;
+        std::size_t sampleIndex;
+        if ((error = getSampleInfo(sequenceId, itemId, sampleTable, sampleIndex)) != ErrorCode::OK)
         {
             return error;
         }
-        width = sampleInfo.width;
+        width = sampleTable->width(sampleIndex);
 
         return ErrorCode::OK;
     }
@@ -217,12 +231,13 @@ namespace HEIF
                                         uint32_t& height) const
     {
         ErrorCode error;
-        SampleProperties sampleInfo;
-        if ((error = getSampleInfo(sequenceId, itemId, sampleInfo)) != ErrorCode::OK)
+        const SampleTable* sampleTable;
+        std::size_t sampleIndex;
+        if ((error = getSampleInfo(sequenceId, itemId, sampleTable, sampleIndex)) != ErrorCode::OK)
         {
             return error;
         }
-        height = sampleInfo.height;
+        height = sampleTable->height(sampleIndex);
 
         return ErrorCode::OK;
     }
@@ -268,6 +283,11 @@ namespace HEIF
             return error;
         }
 
+        if ((error = loadSampleTable(sequenceId)) != ErrorCode::OK)
+        {
+            return error;
+        }
+
         std::int64_t maxTimeUs  = 0;
         std::uint32_t timescale = mFileProperties.initTrackInfos.at(sequenceId).timeScale;
         for (const auto& segment : mFileProperties.segmentPropertiesMap)
@@ -275,12 +295,14 @@ namespace HEIF
             const auto& trackInfo = segment.second.trackInfos.find(sequenceId);
             if (trackInfo != segment.second.trackInfos.end())
             {
-                for (const auto& sample : trackInfo->second.samples)
+                const SampleTable& samples = trackInfo->second.samples;
+                for (std::size_t index = 0; index < samples.size(); ++index)
                 {
-                    for (const auto& compositionTimesTS : sample.compositionTimesTS)
+                    const std::uint32_t sampleDurationTS = samples.sampleDurationTS(index);
+                    for (const auto& compositionTimesTS : samples.compositionTimesTS(index))
                     {
                         maxTimeUs = std::max(
-                            maxTimeUs, int64_t((compositionTimesTS + sample.sampleDurationTS) * 1000000 / timescale));
+                            maxTimeUs, int64_t((compositionTimesTS + sampleDurationTS) * 1000000 / timescale));
                     }
                 }
             }
@@ -390,10 +412,10 @@ namespace HEIF
                 if (hasTrackInfo(segTrackId))
                 {
                     SequenceImageId sampleBase;
-                    const SamplePropertyVector& sampleInfo = getSampleInfo(segTrackId, sampleBase);
+                    const SampleTable& sampleInfo = getSampleInfo(segTrackId, sampleBase);
                     for (uint32_t index = 0; index < sampleInfo.size(); ++index)
                     {
-                        if (sampleInfo[index].sampleType == SampleType::OUTPUT_REFERENCE_FRAME)
+                        if (sampleInfo.sampleType(index) == SampleType::OUTPUT_REFERENCE_FRAME)
                         {
                             matches.push_back(index + sampleBase.get());
                         }
@@ -405,10 +427,10 @@ namespace HEIF
                 if (hasTrackInfo(segTrackId))
                 {
                     SequenceImageId sampleBase;
-                    const SamplePropertyVector& sampleInfo = getSampleInfo(segTrackId, sampleBase);
+                    const SampleTable& sampleInfo = getSampleInfo(segTrackId, sampleBase);
                     for (uint32_t index = 0; index < sampleInfo.size(); ++index)
                     {
-                        if (sampleInfo[index].sampleType == SampleType::NON_OUTPUT_REFERENCE_FRAME)
+                        if (sampleInfo.sampleType(index) == SampleType::NON_OUTPUT_REFERENCE_FRAME)
                         {
                             matches.push_back(index + sampleBase.get());
                         }
@@ -420,10 +442,10 @@ namespace HEIF
                 if (hasTrackInfo(segTrackId))
                 {
                     SequenceImageId sampleBase;
-                    const SamplePropertyVector& sampleInfo = getSampleInfo(segTrackId, sampleBase);
+                    const SampleTable& sampleInfo = getSampleInfo(segTrackId, sampleBase);
                     for (uint32_t index = 0; index < sampleInfo.size(); ++index)
                     {
-                        if (sampleInfo[index].sampleType == SampleType::OUTPUT_NON_REFERENCE_FRAME)
+                        if (sampleInfo.sampleType(index) == SampleType::OUTPUT_NON_REFERENCE_FRAME)
                         {
                             matches.push_back(index + sampleBase.get());
                         }
@@ -437,11 +459,11 @@ namespace HEIF
                     Vector<SequenceImageId> sampleIds;
                     // Collect frames to display
                     SequenceImageId sampleBase;
-                    const SamplePropertyVector& sampleInfo = getSampleInfo(segTrackId, sampleBase);
+                    const SampleTable& sampleInfo = getSampleInfo(segTrackId, sampleBase);
                     for (uint32_t index = 0; index < sampleInfo.size(); ++index)
                     {
-                        if (sampleInfo[index].sampleType == SampleType::OUTPUT_NON_REFERENCE_FRAME ||
-                            sampleInfo[index].sampleType == SampleType::OUTPUT_REFERENCE_FRAME)
+                        if (sampleInfo.sampleType(index) == SampleType::OUTPUT_NON_REFERENCE_FRAME ||
+                            sampleInfo.sampleType(index) == SampleType::OUTPUT_REFERENCE_FRAME)
                         {
                             sampleIds.push_back(index + sampleBase.get());
                         }
@@ -451,9 +473,8 @@ namespace HEIF
                     Vector<ItemIdTimestampPair> samplePresentationTimes;
                     for (auto sampleId : sampleIds)
                     {
-                        const auto& trackInfo = getTrackInfo(segTrackId);
                         const auto singleSamplePresentationTimes =
-                            trackInfo.samples.at(sampleId.get() - trackInfo.itemIdBase.get()).compositionTimes;
+                            sampleInfo.compositionTimes(sampleId.get() - sampleBase.get());
                         for (auto sampleTime : singleSamplePresentationTimes)
                         {
                             samplePresentationTimes.push_back(std::make_pair(sampleId, sampleTime));
@@ -513,12 +534,13 @@ namespace HEIF
                                           FourCC& type) const
     {
         ErrorCode error;
-        SampleProperties sampleInfo;
-        if ((error = getSampleInfo(sequenceId, sequenceImageId, sampleInfo)) != ErrorCode::OK)
+        const SampleTable* sampleTable;
+        std::size_t sampleIndex;
+        if ((error = getSampleInfo(sequenceId, sequenceImageId, sampleTable, sampleIndex)) != ErrorCode::OK)
         {
             return error;
         }
-        type = sampleInfo.sampleEntryType.getUInt32();
+        type = sampleTable->sampleEntryType(sampleIndex).getUInt32();
 
         return ErrorCode::OK;
     }
@@ -640,7 +662,6 @@ namespace HEIF
         memoryBufferSize = static_cast<uint32_t>(itemLength);
 
         // read NAL data to bitstream object
-        bool processData = false;
         try
         {
             error = readItem(mMetaBox, itemId, memoryBuffer, memoryBufferSize);
@@ -660,8 +681,19 @@ namespace HEIF
             return ErrorCode::FILE_READ_ERROR;
         }
 
+        if (bytestreamHeaders)
+        {
+            return processItemData(itemId, memoryBuffer, memoryBufferSize);
+        }
+        return ErrorCode::OK;
+    }
+
+    ErrorCode HeifReaderImpl::processItemData(const ImageId& itemId,
+                                              uint8_t* memoryBuffer,
+                                              uint64_t& memoryBufferSize) const
+    {
         FourCCInt rawType;
-        error = getRawItemType(mMetaBox, itemId, rawType);
+        ErrorCode error = getRawItemType(mMetaBox, itemId, rawType);
         if (error != ErrorCode::OK)
         {
             return error;
@@ -672,45 +704,205 @@ namespace HEIF
         {
             return error;
         }
-        if (!isProtected && ((rawType == "hvc1") || (rawType == "avc1")))
+        if (isProtected || ((rawType != "hvc1") && (rawType != "avc1")))
         {
-            processData = true;
+            return ErrorCode::OK;
         }
 
-        if (processData && bytestreamHeaders)
+        // Process bitstream by codec
+        FourCC codeType;
+        error = getDecoderCodeType(itemId, codeType);
+        if (error != ErrorCode::OK)
         {
-            // Process bitstream by codec
-            FourCC codeType;
-            error = getDecoderCodeType(itemId, codeType);
-            if (error != ErrorCode::OK)
+            return error;
+        }
+
+        if (codeType == FourCC("avc1"))
+        {
+            // Get item data from AVC bitstream
+            return processAvcItemData(memoryBuffer, memoryBufferSize);
+        }
+        else if (codeType == FourCC("hvc1"))
+        {
+            // Get item data from HEVC bitstream
+            return processHevcItemData(memoryBuffer, memoryBufferSize);
+        }
+
+        // Code type not supported
+        return ErrorCode::UNSUPPORTED_CODE_TYPE;
+    }
+
+    ErrorCode HeifReaderImpl::getItemDataBatch(const Array<ImageId>& imageIds,
+                                               Array<ItemDataBuffer>& buffers,
+                                               bool bytestreamHeaders) const
+    {
+        if (isInitialized() != ErrorCode::OK)
+        {
+            return ErrorCode::UNINITIALIZED;
+        }
+        if (imageIds.size != buffers.size)
+        {
+            return ErrorCode::INVALID_FUNCTION_PARAMETER;
+        }
+
+        const auto& io = mFileProperties.segmentPropertiesMap.at(0).io;
+
+        // Resolve item lengths first so that nothing is read if any of the buffers is too small.
+        ErrorCode error;
+        bool buffersTooSmall = false;
+        for (size_t i = 0; i < imageIds.size; ++i)
+        {
+            if ((error = isValidItem(imageIds[i])) != ErrorCode::OK)
             {
                 return error;
             }
 
-            if (codeType == FourCC("avc1"))
+            std::uint64_t itemLength(0);
+            try
             {
-                // Get item data from AVC bitstream
-                error = processAvcItemData(memoryBuffer, memoryBufferSize);
+                List<ImageId> pastReferences;
+                error = getItemLength(mMetaBox, imageIds[i], itemLength, pastReferences);
                 if (error != ErrorCode::OK)
                 {
                     return error;
                 }
             }
-            else if (codeType == FourCC("hvc1"))
+            catch (...)
             {
-                // Get item data from HEVC bitstream
-                error = processHevcItemData(memoryBuffer, memoryBufferSize);
-                if (error != ErrorCode::OK)
+                return ErrorCode::FILE_READ_ERROR;
+            }
+            if (static_cast<int64_t>(itemLength) > io.size)
+            {
+                return ErrorCode::FILE_HEADER_ERROR;
+            }
+
+            if (buffers[i].memoryBufferSize < itemLength)
+            {
+                buffersTooSmall = true;
+            }
+            buffers[i].memoryBufferSize = itemLength;
+        }
+        if (buffersTooSmall)
+        {
+            return ErrorCode::BUFFER_SIZE_TOO_SMALL;
+        }
+
+        // Collect extents located directly in the file. Other items are read one by one.
+        struct FileExtent
+        {
+            uint64_t offset;
+            uint64_t length;
+            uint8_t* destination;
+        };
+        Vector<FileExtent> fileExtents;
+        try
+        {
+            const ItemLocationBox& iloc = mMetaBox.getItemLocationBox();
+            for (size_t i = 0; i < imageIds.size; ++i)
+            {
+                const ItemLocation& itemLocation = iloc.getItemLocationForID(imageIds[i].get());
+                if (iloc.getVersion() == 0 ||
+                    itemLocation.getConstructionMethod() == ItemLocation::ConstructionMethod::FILE_OFFSET)
                 {
-                    return error;
+                    uint8_t* destination = buffers[i].memoryBuffer;
+                    for (const auto& extent : itemLocation.getExtentList())
+                    {
+                        fileExtents.push_back(
+                            {itemLocation.getBaseOffset() + extent.mExtentOffset, extent.mExtentLength, destination});
+                        destination += extent.mExtentLength;
+                    }
+                }
+                else
+                {
+                    error = readItem(mMetaBox, imageIds[i], buffers[i].memoryBuffer, buffers[i].memoryBufferSize);
+                    if (error != ErrorCode::OK)
+                    {
+                        return error;
+                    }
                 }
             }
-            else
+        }
+        catch (const ISOBMFF::Exception& exc)
+        {
+            logError() << "Error: " << exc.what() << std::endl;
+            return ErrorCode::FILE_READ_ERROR;
+        }
+
+        std::sort(fileExtents.begin(), fileExtents.end(),
+                  [](const FileExtent& a, const FileExtent& b) { return a.offset < b.offset; });
+
+        const char* mapping = io.stream->data();
+        if (mapping != nullptr)
+        {
+            for (const auto& extent : fileExtents)
             {
-                // Code type not supported
-                return ErrorCode::UNSUPPORTED_CODE_TYPE;
+                if (extent.offset > static_cast<uint64_t>(io.size) ||
+                    extent.length > static_cast<uint64_t>(io.size) - extent.offset)
+                {
+                    return ErrorCode::FILE_READ_ERROR;
+                }
+                std::memcpy(extent.destination, mapping + extent.offset, extent.length);
             }
         }
+        else
+        {
+            // Merge extents separated by at most MAX_READ_GAP bytes into one read, bounded by MAX_READ_SPAN.
+            static const uint64_t MAX_READ_GAP  = 64 * 1024;
+            static const uint64_t MAX_READ_SPAN = 16 * 1024 * 1024;
+            Vector<uint8_t> span;
+            size_t first = 0;
+            while (first < fileExtents.size())
+            {
+                const uint64_t spanBegin = fileExtents[first].offset;
+                uint64_t spanEnd         = spanBegin + fileExtents[first].length;
+                size_t last              = first + 1;
+                while (last < fileExtents.size() && fileExtents[last].offset <= spanEnd + MAX_READ_GAP &&
+                       std::max(spanEnd, fileExtents[last].offset + fileExtents[last].length) - spanBegin <=
+                           MAX_READ_SPAN)
+                {
+                    spanEnd = std::max(spanEnd, fileExtents[last].offset + fileExtents[last].length);
+                    ++last;
+                }
+
+                if (last == first + 1)
+                {
+                    if (!io.stream->readAt(static_cast<int64_t>(spanBegin),
+                                           reinterpret_cast<char*>(fileExtents[first].destination),
+                                           static_cast<int64_t>(fileExtents[first].length)))
+                    {
+                        return ErrorCode::FILE_READ_ERROR;
+                    }
+                }
+                else
+                {
+                    span.resize(spanEnd - spanBegin);
+                    if (!io.stream->readAt(static_cast<int64_t>(spanBegin), reinterpret_cast<char*>(span.data()),
+                                           static_cast<int64_t>(span.size())))
+                    {
+                        return ErrorCode::FILE_READ_ERROR;
+                    }
+                    for (size_t i = first; i < last; ++i)
+                    {
+                        std::memcpy(fileExtents[i].destination, span.data() + (fileExtents[i].offset - spanBegin),
+                                    fileExtents[i].length);
+                    }
+                }
+                first = last;
+            }
+        }
+
+        if (bytestreamHeaders)
+        {
+            for (size_t i = 0; i < imageIds.size; ++i)
+            {
+                error = processItemData(imageIds[i], buffers[i].memoryBuffer, buffers[i].memoryBufferSize);
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+            }
+        }
+
         return ErrorCode::OK;
     }
 
@@ -776,6 +968,48 @@ namespace HEIF
         return ErrorCode::OK;
     }
 
+    ErrorCode HeifReaderImpl::getItemDataView(const ImageId& itemId, const uint8_t*& data, uint64_t& dataSize) const
+    {
+        ErrorCode error;
+        if ((error = isValidItem(itemId)) != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        const auto& io      = mFileProperties.segmentPropertiesMap.at(0).io;
+        const char* mapping = io.stream->data();
+        if (mapping == nullptr)
+        {
+            return ErrorCode::NOT_APPLICABLE;
+        }
+
+        const ItemLocationBox& iloc = mMetaBox.getItemLocationBox();
+        if (!iloc.hasItemIdEntry(itemId.get()))
+        {
+            return ErrorCode::INVALID_ITEM_ID;
+        }
+        const ItemLocation& itemLocation = iloc.getItemLocationForID(itemId.get());
+        const ExtentList& extentList     = itemLocation.getExtentList();
+        if ((iloc.getVersion() >= 1 &&
+             itemLocation.getConstructionMethod() != ItemLocation::ConstructionMethod::FILE_OFFSET) ||
+            extentList.size() != 1)
+        {
+            return ErrorCode::NOT_APPLICABLE;
+        }
+
+        const uint64_t offset = itemLocation.getBaseOffset() + extentList.front().mExtentOffset;
+        const uint64_t length = extentList.front().mExtentLength;
+        if (offset > static_cast<uint64_t>(io.size) || length > static_cast<uint64_t>(io.size) - offset)
+        {
+            return ErrorCode::FILE_READ_ERROR;
+        }
+
+        data     = reinterpret_cast<const uint8_t*>(mapping) + offset;
+        dataSize = length;
+
+        return ErrorCode::OK;
+    }
+
     ErrorCode HeifReaderImpl::getTrackSampleData(const SequenceId& trackId,
                                                  const SequenceImageId& itemIdApi,
                                                  uint8_t* memoryBuffer,
@@ -794,61 +1028,61 @@ namespace HEIF
             return result;
         }
         SegmentTrackId segTrackId = std::make_pair(segmentId, trackId);
-        SequenceImageId itemId    = itemIdApi.get() - getTrackInfo(segTrackId).itemIdBase.get();
+        auto& segmentProperties   = mFileProperties.segmentPropertiesMap.at(segmentId);
+        SequenceImageId itemId    = itemIdApi.get() - segmentProperties.trackInfos.at(trackId).itemIdBase.get();
 
-        auto& io = mFileProperties.segmentPropertiesMap.at(segmentId).io;
+        auto& io = segmentProperties.io;
         // read NAL data to bitstream object
 
-        // The requested frame should be one that is available
-        if (itemId.get() >= getTrackInfo(segTrackId).samples.size())
+        // The requested frame should be one that is available; a pending sample table is not expanded for this.
+        std::uint64_t sampleDataOffset;
+        std::uint32_t sampleLength;
+        SampleDescriptionIndex sampleDescriptionIndex;
+        result = getSampleLocation(segTrackId, itemId.get(), sampleDataOffset, sampleLength, sampleDescriptionIndex);
+        if (result == ErrorCode::INVALID_SEQUENCE_IMAGE_ID)
         {
             return ErrorCode::INVALID_ITEM_ID;
         }
+        if (result != ErrorCode::OK)
+        {
+            return result;
+        }
 
-        const uint32_t sampleLength = getTrackInfo(segTrackId).samples.at(itemId.get()).dataLength;
         if (memoryBufferSize < sampleLength)
         {
             memoryBufferSize = sampleLength;
             return ErrorCode::MEMORY_TOO_SMALL_BUFFER;
         }
 
-        seekInput(io, static_cast<std::int64_t>(getTrackInfo(segTrackId).samples.at(itemId.get()).dataOffset));
-        io.stream->read(reinterpret_cast<char*>(memoryBuffer), sampleLength);
-        memoryBufferSize = sampleLength;
-
-        if (!io.stream->good())
+        const auto sampleOffset = static_cast<std::int64_t>(sampleDataOffset);
+        if (!io.stream->readAt(sampleOffset, reinterpret_cast<char*>(memoryBuffer), sampleLength))
         {
             return ErrorCode::FILE_READ_ERROR;
         }
+        memoryBufferSize = sampleLength;
 
         return ErrorCode::OK;
     }
 
     ErrorCode HeifReaderImpl::segmentIdOf(SequenceId sequenceId, SequenceImageId itemId, SegmentId& segmentId) const
     {
-        bool wentPast = false;
-
         if (mFileProperties.segmentPropertiesMap.empty())
         {
             return ErrorCode::INVALID_SEGMENT;
         }
 
-        const auto& segs = segmentsBySequence();
-        for (auto segmentIt = segs.begin(); !wentPast && segmentIt != segs.end(); ++segmentIt)
+        // The last segment, in sequence order, of those where the samples of the track start at or before itemId.
+        const auto index = mFileProperties.sampleIdToSegment.find(sequenceId);
+        if (index == mFileProperties.sampleIdToSegment.end())
         {
-            auto track = segmentIt->trackInfos.find(sequenceId);
-            if (track != segmentIt->trackInfos.end())
-            {
-                if (track->second.itemIdBase > itemId)
-                {
-                    wentPast = true;
-                }
-                else
-                {
-                    segmentId = segmentIt->segmentId;
-                }
-            }
+            return ErrorCode::INVALID_SEQUENCE_IMAGE_ID;
         }
+        auto entry = index->second.upper_bound(std::make_pair(itemId, Sequence(std::numeric_limits<std::uint32_t>::max())));
+        if (entry == index->second.begin())
+        {
+            return ErrorCode::INVALID_SEQUENCE_IMAGE_ID;
+        }
+        segmentId = (--entry)->second;
 
         auto ret     = ErrorCode::INVALID_SEQUENCE_IMAGE_ID;
         auto segment = mFileProperties.segmentPropertiesMap.find(segmentId);
@@ -857,7 +1091,8 @@ namespace HEIF
             auto track = segment->second.trackInfos.find(sequenceId);
             if (track != segment->second.trackInfos.end())
             {
-                if (itemId.get() - track->second.itemIdBase.get() < std::uint32_t(track->second.samples.size()))
+                if (itemId.get() - track->second.itemIdBase.get() <
+                    std::uint32_t(getSampleCount({segmentId, sequenceId}, track->second)))
                 {
                     ret = ErrorCode::OK;
                 }
@@ -1445,6 +1680,10 @@ namespace HEIF
         {
             return error;
         }
+        if ((error = loadSampleTable(sequenceId)) != ErrorCode::OK)
+        {
+            return error;
+        }
 
         WriteOnceMap<Timestamp, SequenceImageId> timestampMap;
 
@@ -1454,15 +1693,16 @@ namespace HEIF
             SegmentTrackId segTrackId = std::make_pair(segmentId, sequenceId);
             if (hasTrackInfo(segTrackId))
             {
-                for (const auto& sampleInfo : getTrackInfo(segTrackId).samples)
+                const SampleTable& samples = getTrackInfo(segTrackId).samples;
+                for (std::size_t index = 0; index < samples.size(); ++index)
                 {
-                    if (sampleInfo.sampleType == SampleType::NON_OUTPUT_REFERENCE_FRAME)
+                    if (samples.sampleType(index) == SampleType::NON_OUTPUT_REFERENCE_FRAME)
                     {
                         continue;
                     }
-                    for (auto compositionTime : sampleInfo.compositionTimes)
+                    for (auto compositionTime : samples.compositionTimes(index))
                     {
-                        timestampMap.insert(std::make_pair(compositionTime, sampleInfo.sampleId));
+                        timestampMap.insert(std::make_pair(compositionTime, samples.sampleId(index)));
                     }
                 }
             }
@@ -1490,6 +1730,10 @@ namespace HEIF
         {
             return error;
         }
+        if ((error = loadSampleTable(sequenceId)) != ErrorCode::OK)
+        {
+            return error;
+        }
 
         SegmentId segmentId;
         error = segmentIdOf(sequenceId, itemIdApi, segmentId);
@@ -1500,7 +1744,7 @@ namespace HEIF
         SequenceImageId itemId = itemIdApi.get() - getTrackInfo(SegmentTrackId(segmentId, sequenceId)).itemIdBase.get();
         SegmentTrackId segTrackId = std::make_pair(segmentId, sequenceId);
 
-        const auto& displayTimes = getTrackInfo(segTrackId).samples.at(itemId.get()).compositionTimes;
+        const auto displayTimes = getTrackInfo(segTrackId).samples.compositionTimes(itemId.get());
 
         timestamps = makeArray<int64_t>(displayTimes);
         return ErrorCode::OK;
@@ -1514,6 +1758,10 @@ namespace HEIF
         {
             return error;
         }
+        if ((error = loadSampleTable(sequenceId)) != ErrorCode::OK)
+        {
+            return error;
+        }
 
         DecodingOrderVector decodingOrderVector;
 
@@ -1526,11 +1774,11 @@ namespace HEIF
             {
                 const auto& samples = getTrackInfo(segTrackId).samples;
                 decodingOrderVector.reserve(samples.size());
-                for (const auto& sample : samples)
+                for (std::size_t index = 0; index < samples.size(); ++index)
                 {
-                    for (const auto compositionTime : sample.compositionTimes)
+                    for (const auto compositionTime : samples.compositionTimes(index))
                     {
-                        decodingOrderVector.push_back({compositionTime, sample.sampleId});
+                        decodingOrderVector.push_back({compositionTime, samples.sampleId(index)});
                     }
                 }
 
@@ -1557,15 +1805,16 @@ namespace HEIF
                                                     Array<SequenceImageId>& dependencies) const
     {
         ErrorCode error;
-        SampleProperties sampleInfo;
-        if ((error = getSampleInfo(sequenceId, itemId, sampleInfo)) != ErrorCode::OK)
+        const SampleTable* sampleTable;
+        std::size_t sampleIndex;
+        if ((error = getSampleInfo(sequenceId, itemId, sampleTable, sampleIndex)) != ErrorCode::OK)
         {
             return error;
         }
 
         Vector<SequenceImageId> dependencyVector;
-        const auto& decodeDependencies = sampleInfo.decodeDependencies;
-        dependencyVector.insert(dependencyVector.begin(), decodeDependencies.cbegin(), decodeDependencies.cend());
+        const auto decodeDependencies = sampleTable->decodeDependencies(sampleIndex);
+        dependencyVector.insert(dependencyVector.begin(), decodeDependencies.begin(), decodeDependencies.end());
 
         // For I-frames return item id itself.
         if (dependencyVector.empty())
@@ -1577,6 +1826,43 @@ namespace HEIF
         return ErrorCode::OK;
     }
 
+    ErrorCode HeifReaderImpl::getSeekSamples(const SequenceId& sequenceId,
+                                             const std::int64_t timestamp,
+                                             Array<SequenceImageId>& samples) const
+    {
+        ErrorCode error;
+        if ((error = isValidTrack(sequenceId)) != ErrorCode::OK)
+        {
+            return error;
+        }
+        if ((error = loadSampleTable(sequenceId)) != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        std::lock_guard<std::mutex> lock(mSeekIndexMutex);
+        const SeekIndex& seekIndex = getSeekIndex(sequenceId);
+        if (seekIndex.times.empty())
+        {
+            return ErrorCode::INVALID_SEQUENCE_IMAGE_ID;
+        }
+
+        // Last sample displayed at or before the timestamp, or the first displayed sample.
+        auto time = std::upper_bound(seekIndex.times.begin(), seekIndex.times.end(), timestamp);
+        if (time != seekIndex.times.begin())
+        {
+            --time;
+        }
+        const std::uint32_t presented = seekIndex.timeSamples[static_cast<std::size_t>(time - seekIndex.times.begin())];
+
+        // Nearest sync sample at or before it in decoding order. Without one, decode from the start of the track.
+        auto sync = std::upper_bound(seekIndex.syncSamples.begin(), seekIndex.syncSamples.end(), presented);
+        const std::uint32_t start = (sync != seekIndex.syncSamples.begin()) ? *(--sync) : 0;
+
+        samples = Array<SequenceImageId>(seekIndex.samples.begin() + start, seekIndex.samples.begin() + presented + 1);
+        return ErrorCode::OK;
+    }
+
     ErrorCode HeifReaderImpl::getDecoderCodeType(const ImageId& itemId, FourCC& type) const
     {
         ErrorCode error;
@@ -1624,14 +1910,49 @@ namespace HEIF
             return ErrorCode::INVALID_SEQUENCE_ID;
         }
         const TrackInfoInSegment& trackInfo = trackInfoIt->second;
-        const auto& decoderCodeTypeMap      = trackInfo.decoderCodeTypeMap;
+        const std::uint32_t sampleIndex     = sampleId.get() - trackInfo.itemIdBase.get();
+
+        if (const TrackBox* trackBox = getPendingTrackBox(segTrackId))
+        {
+            // Resolve the sample entry of a pending sample table the same way makeSampleTable() does.
+            std::uint64_t dataOffset;
+            std::uint32_t dataLength;
+            SampleDescriptionIndex sampleDescriptionIndex;
+            if (getSampleLocation(segTrackId, sampleIndex, dataOffset, dataLength, sampleDescriptionIndex) !=
+                ErrorCode::OK)
+            {
+                return ErrorCode::INVALID_SEQUENCE_IMAGE_ID;
+            }
+            FourCCInt sampleEntryType;
+            const FourCCInt handlerType = trackBox->getMediaBox().getHandlerBox().getHandlerType();
+            if (handlerType == "pict" || handlerType == "vide" || handlerType == "auxv" || handlerType == "soun")
+            {
+                const auto sampleEntry = static_cast<const SampleEntryBox*>(
+                    trackBox->getMediaBox().getMediaInformationBox().getSampleTableBox().getSampleDescriptionBox()
+                        .getSampleEntry(sampleDescriptionIndex.get()));
+                if (sampleEntry != nullptr)
+                {
+                    sampleEntryType = sampleEntry->getType();
+                }
+            }
+            decoderCodeType = sampleEntryType.getUInt32();
+            return ErrorCode::OK;
+        }
 
-        auto iter = decoderCodeTypeMap.find(sampleId);
-        if (iter != decoderCodeTypeMap.end())
+        const SampleTable& samples = trackInfo.samples;
+        if (sampleIndex < samples.size() && samples.sampleId(sampleIndex) == sampleId)
         {
-            decoderCodeType = iter->second.getUInt32();
+            decoderCodeType = samples.sampleEntryType(sampleIndex).getUInt32();
             return ErrorCode::OK;
         }
+        for (std::size_t index = 0; index < samples.size(); ++index)
+        {
+            if (samples.sampleId(index) == sampleId)
+            {
+                decoderCodeType = samples.sampleEntryType(index).getUInt32();
+                return ErrorCode::OK;
+            }
+        }
 
         return ErrorCode::INVALID_SEQUENCE_IMAGE_ID;
     }
@@ -1745,6 +2066,12 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        const ErrorCode error = loadSampleTables();
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+
         const size_t totalSize   = mFileProperties.initTrackInfos.size();
         trackInfos               = Array<TrackInformation>(totalSize);
         uint32_t outTrackIdxBase = 0;
@@ -1849,43 +2176,46 @@ namespace HEIF
                     if (!trackInfo.samples.empty())
                     {
                         std::uint64_t sum = 0;
-                        for (const auto& sample : trackInfo.samples)
+                        for (std::size_t index = 0; index < trackInfo.samples.size(); ++index)
                         {
-                            sum += static_cast<std::uint64_t>(sample.sampleDurationTS);
+                            sum += static_cast<std::uint64_t>(trackInfo.samples.sampleDurationTS(index));
                         }
                         auto timeScale = mFileProperties.initTrackInfos.at(trackId).timeScale;
                         trackInfos.elements[outTrackIdx].frameRate =
                             Rational{timeScale, sum / trackInfo.samples.size()};
                     }
 
-                    for (auto const& sample : trackInfo.samples)
+                    const SampleTable& samples = trackInfo.samples;
+                    for (std::size_t index = 0; index < samples.size(); ++index)
                     {
-                        trackInfos.elements[outTrackIdx].sampleProperties[i].sampleId = sample.sampleId.get();
+                        trackInfos.elements[outTrackIdx].sampleProperties[i].sampleId = samples.sampleId(index).get();
                         trackInfos.elements[outTrackIdx].sampleProperties[i].sampleEntryType =
-                            sample.sampleEntryType.getUInt32();
+                            samples.sampleEntryType(index).getUInt32();
                         trackInfos.elements[outTrackIdx].sampleProperties[i].sampleDescriptionIndex =
-                            sample.sampleDescriptionIndex.get();
-                        trackInfos.elements[outTrackIdx].sampleProperties[i].sampleType = sample.sampleType;
+                            samples.sampleDescriptionIndex(index).get();
+                        trackInfos.elements[outTrackIdx].sampleProperties[i].sampleType = samples.sampleType(index);
                         trackInfos.elements[outTrackIdx].sampleProperties[i].segmentId  = segment.segmentId.get();
-                        if (!sample.compositionTimes.empty() != 0u)
+                        const auto compositionTimes = samples.compositionTimes(index);
+                        if (!compositionTimes.empty())
                         {
                             // Edit list has been applied to these timestamps already, so negative times shouldn't be
                             // present.
                             trackInfos.elements[outTrackIdx].sampleProperties[i].earliestTimestamp =
-                                static_cast<std::uint64_t>(sample.compositionTimes.at(0));
+                                static_cast<std::uint64_t>(compositionTimes.at(0));
                             trackInfos.elements[outTrackIdx].sampleProperties[i].earliestTimestampTS =
-                                sample.compositionTimesTS.at(0);
+                                samples.compositionTimesTS(index).at(0);
                         }
                         else
                         {
                             trackInfos.elements[outTrackIdx].sampleProperties[i].earliestTimestamp   = 0;
                             trackInfos.elements[outTrackIdx].sampleProperties[i].earliestTimestampTS = 0;
                         }
-                        trackInfos.elements[outTrackIdx].sampleProperties[i].sampleFlags.flagsAsUInt =
-                            sample.sampleFlags.flagsAsUInt;
-                        trackInfos.elements[outTrackIdx].sampleProperties[i].sampleDurationTS = sample.sampleDurationTS;
+                        trackInfos.elements[outTrackIdx].sampleProperties[i].sampleFlags =
+                            samples.sampleFlags(index);
+                        trackInfos.elements[outTrackIdx].sampleProperties[i].sampleDurationTS =
+                            samples.sampleDurationTS(index);
 
-                        unsigned int sampleSize = sample.dataLength;
+                        unsigned int sampleSize = samples.dataLength(index);
                         if (sampleSize > trackInfos.elements[outTrackIdx].maxSampleSize)
                         {
                             trackInfos.elements[outTrackIdx].maxSampleSize = sampleSize;
@@ -48,6 +48,7 @@
 #include "moviebox.hpp"
 #include "moviefragmentbox.hpp"
 #include "mp4audiosampleentrybox.hpp"
+#include "nalutil.hpp"
 #include "requiredreferencetypesproperty.hpp"
 #include "sampletometadataitementry.hpp"
 #include "segmentindexbox.hpp"
@@ -73,6 +74,13 @@ namespace HEIF
             return array;
         }
 
+        bool isImageItemType(const FourCCInt& type, const String& contentType)
+        {
+            static const std::set<FourCCInt> IMAGE_TYPES = {"avc1", "hvc1", "grid", "iovl", "iden", "jpeg"};
+
+            return (IMAGE_TYPES.count(type) != 0u) || (type == "mime" && contentType == "image/jpeg");
+        }
+
     }  // anonymous namespace
 
     /* ********************************************************************** */
@@ -84,7 +92,31 @@ namespace HEIF
         , mIsPrimaryItemSet(false)
         , mPrimaryItemId(0)
         , mMetaBoxLoaded(false)
+        , mLazySampleTables(false)
+        , mReadAheadSize(InternalStream::DEFAULT_READ_AHEAD_SIZE)
+        , mHeaderOnly(false)
+        , mPendingSampleTableCount(0)
+    {
+    }
+
+    ErrorCode HeifReaderImpl::setLazySampleTables(const bool lazy)
     {
+        if (mState != State::UNINITIALIZED)
+        {
+            return ErrorCode::ALREADY_INITIALIZED;
+        }
+        mLazySampleTables = lazy;
+        return ErrorCode::OK;
+    }
+
+    ErrorCode HeifReaderImpl::setReadAheadSize(const std::uint32_t size)
+    {
+        if (mState != State::UNINITIALIZED)
+        {
+            return ErrorCode::ALREADY_INITIALIZED;
+        }
+        mReadAheadSize = size;
+        return ErrorCode::OK;
     }
 
     ErrorCode HeifReaderImpl::initialize(const char* fileName)
@@ -102,7 +134,53 @@ namespace HEIF
 
     ErrorCode HeifReaderImpl::initialize(StreamInterface* stream)
     {
-        UniquePtr<InternalStream> internalStream(CUSTOM_NEW(InternalStream, (stream)));
+        const ErrorCode error = openStream(stream, false);
+        if (error == ErrorCode::OK)
+        {
+            mFileInformation = makeFileInformation(mFileProperties);
+        }
+        return error;
+    }
+
+    ErrorCode HeifReaderImpl::probe(const char* fileName, ProbeInformation& probeInfo)
+    {
+        ErrorCode rc;
+        auto& io = mFileStream;
+        io.fileStream.reset(openFile(fileName));
+        rc = probe(&*io.fileStream, probeInfo);
+        if (rc != ErrorCode::OK)
+        {
+            io.fileStream.reset();
+        }
+        return rc;
+    }
+
+    ErrorCode HeifReaderImpl::probe(StreamInterface* stream, ProbeInformation& probeInfo)
+    {
+        const ErrorCode error = openStream(stream, true);
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        probeInfo                  = {};
+        probeInfo.majorBrand       = FourCC(mFtyp.getMajorBrand().getUInt32());
+        probeInfo.features         = mFileProperties.fileFeature.getFeatureMask();
+        probeInfo.masterImageCount = mMetaBoxInfo.displayableMasterImages;
+        if (mIsPrimaryItemSet)
+        {
+            probeInfo.hasPrimaryItem = true;
+            probeInfo.primaryItemId  = mPrimaryItemId;
+            getWidth(mPrimaryItemId, probeInfo.width);
+            getHeight(mPrimaryItemId, probeInfo.height);
+            getReferencedToItemListByType(mPrimaryItemId, "thmb", probeInfo.thumbnailIds);
+        }
+        return ErrorCode::OK;
+    }
+
+    ErrorCode HeifReaderImpl::openStream(StreamInterface* stream, const bool headerOnly)
+    {
+        UniquePtr<InternalStream> internalStream(CUSTOM_NEW(InternalStream, (stream, mReadAheadSize)));
 
         if (!internalStream->good())
         {
@@ -110,6 +188,7 @@ namespace HEIF
         }
 
         reset();
+        mHeaderOnly = headerOnly;
 
         SegmentId segmentId = 0;  // Initialization segment id
         auto& io            = mFileProperties.segmentPropertiesMap[segmentId].io;   // io是什么？
@@ -135,8 +214,6 @@ namespace HEIF
             return ErrorCode::FILE_READ_ERROR;
         }
 
-        mFileInformation = makeFileInformation(mFileProperties);
-
         return ErrorCode::OK;
     }
 
@@ -165,12 +242,17 @@ namespace HEIF
         }
 
         auto& segmentProperties = mFileProperties.segmentPropertiesMap.at(segmentId);
+        for (const auto& trackInfo : segmentProperties.trackInfos)
+        {
+            unindexSegmentTrack(segmentId, trackInfo.first);
+        }
         auto& sequenceToSegment = mFileProperties.sequenceToSegment;
         for (const auto& sequence : segmentProperties.sequences)
         {
             sequenceToSegment.erase(sequence);
         }
         mFileProperties.segmentPropertiesMap.erase(segmentId);
+        clearSeekIndexes();
 
         return ErrorCode::OK;
     }
@@ -185,7 +267,7 @@ namespace HEIF
                                                 Array<SegmentInformation>& segmentIndex)
     {
         StreamIO io;
-        io.stream.reset(CUSTOM_NEW(InternalStream, (streamInterface)));
+        io.stream.reset(CUSTOM_NEW(InternalStream, (streamInterface, mReadAheadSize)));
         if (io.stream->peekEof())
         {
             io.stream.reset();
@@ -271,10 +353,11 @@ namespace HEIF
 
         State prevState = mState;
         mState          = State::INITIALIZING;
+        clearSeekIndexes();
 
         SegmentProperties& segmentProperties = mFileProperties.segmentPropertiesMap[segmentId];
         StreamIO& io                         = segmentProperties.io;
-        io.stream.reset(CUSTOM_NEW(InternalStream, (streamInterface)));
+        io.stream.reset(CUSTOM_NEW(InternalStream, (streamInterface, mReadAheadSize)));
         if (io.stream->peekEof())
         {
             mState = prevState;
@@ -451,10 +534,16 @@ namespace HEIF
         mMetaBoxInfo      = {};
         mMetaBoxLoaded    = false;
         mPrimaryItemId    = 0;
+        mHeaderOnly       = false;
 
         mImageItemCodeTypeMap.clear();
         mImageItemParameterSetMap.clear();
         mImageToParameterSetMap.clear();
+
+        mPendingSampleTables.clear();
+        mPendingSampleTableCount = 0;
+        mLazyMovieBox.reset();
+        clearSeekIndexes();
     }
 
     MetaBoxInformation HeifReaderImpl::convertRootMetaBoxInformation(const MetaBoxProperties& metaboxProperties) const
@@ -530,25 +619,29 @@ namespace HEIF
             }
 
             const SegmentId intializationSegmentId = 0;
-            const SamplePropertyVector& samplePropertyVector =
-                mFileProperties.segmentPropertiesMap.at(intializationSegmentId)
-                    .trackInfos.at(trackInfoOut[i].trackId)
-                    .samples;
-            Array<SampleInformation> sampleInfo(samplePropertyVector.size());
-            unsigned int j = 0;
-            for (const auto& sampleProp : samplePropertyVector)
-            {
-                sampleInfo[j].sampleId                  = sampleProp.sampleId;
-                sampleInfo[j].sampleEntryType           = sampleProp.sampleEntryType.getUInt32();
-                sampleInfo[j].sampleDescriptionIndex    = sampleProp.sampleDescriptionIndex.get();
-                sampleInfo[j].sampleType                = sampleProp.sampleType;
-                sampleInfo[j].sampleDurationTS          = sampleProp.sampleDurationTS;
-                sampleInfo[j].sampleCompositionOffsetTs = sampleProp.sampleCompositionOffsetTs;
-                sampleInfo[j].hasClap                   = sampleProp.hasClap;
-                sampleInfo[j].hasAuxi                   = sampleProp.hasAuxi;
-                sampleInfo[j].codingConstraints         = sampleProp.codingConstraints;
-                sampleInfo[j].size                      = sampleProp.dataLength;
-                ++j;
+            if (mPendingSampleTables.count(trackInfoOut[i].trackId) != 0u)
+            {
+                // Per-sample information of lazily loaded tracks is only available through getTrackInformations().
+                ++i;
+                continue;
+            }
+            const SampleTable& sampleTable = mFileProperties.segmentPropertiesMap.at(intializationSegmentId)
+                                                 .trackInfos.at(trackInfoOut[i].trackId)
+                                                 .samples;
+            Array<SampleInformation> sampleInfo(sampleTable.size());
+            for (std::size_t j = 0; j < sampleTable.size(); ++j)
+            {
+                sampleInfo[j].sampleId                  = sampleTable.sampleId(j);
+                sampleInfo[j].sampleEntryType           = sampleTable.sampleEntryType(j).getUInt32();
+                sampleInfo[j].sampleDescriptionIndex    = sampleTable.sampleDescriptionIndex(j).get();
+                sampleInfo[j].sampleType                = sampleTable.sampleType(j);
+                sampleInfo[j].sampleDurationTS          = sampleTable.sampleDurationTS(j);
+                sampleInfo[j].sampleCompositionOffsetTs = sampleTable.sampleCompositionOffsetTs(j);
+                sampleInfo[j].hasClap                   = sampleTable.hasClap(j);
+                sampleInfo[j].hasAuxi                   = sampleTable.hasAuxi(j);
+                sampleInfo[j].codingConstraints         = sampleTable.codingConstraints(j);
+                sampleInfo[j].size                      = sampleTable.dataLength(j);
+                sampleInfo[j].sampleFlags               = sampleTable.sampleFlags(j);
             }
             trackInfoOut[i].sampleProperties = sampleInfo;
             ++i;
@@ -601,15 +694,34 @@ namespace HEIF
         auto error = readBox(io, bitstream);
         if (error == ErrorCode::OK)
         {
-            MovieBox moov;
+            UniquePtr<MovieBox> moovPtr(CUSTOM_NEW(MovieBox, ()));
+            MovieBox& moov = *moovPtr;
             moov.parseBox(bitstream);
 
+            // Track fragments extend the sample tables while parsing, so only plain files are loaded lazily.
+            const bool lazy = mLazySampleTables && !moov.isMovieExtendsBoxPresent();
+
             mFileProperties.moovProperties = extractMoovProperties(moov);
-            fillSegmentPropertiesMap(initializationSegmentId, moov, mFileProperties.segmentPropertiesMap);
+            fillSegmentPropertiesMap(initializationSegmentId, moov, mFileProperties.segmentPropertiesMap, !lazy);
+            for (const auto& trackInfo : mFileProperties.segmentPropertiesMap.at(initializationSegmentId).trackInfos)
+            {
+                indexSegmentTrack(initializationSegmentId, trackInfo.first);
+            }
             mFileProperties.initTrackInfos =
                 extractInitTrackInfos(initializationSegmentId, moov, mFileProperties.segmentPropertiesMap);
             mFileProperties.moovProperties.movieTimescale = moov.getMovieHeaderBox().getTimeScale();
             mFileProperties.moovProperties.mMatrix        = moov.getMovieHeaderBox().getMatrix();
+
+            if (lazy)
+            {
+                for (const auto& trackBox : moov.getTrackBoxes())
+                {
+                    const SequenceId sequenceId           = trackBox->getTrackHeaderBox().getTrackID();
+                    mPendingSampleTables[sequenceId] = {trackBox.get(), 0, 0, 0, false};
+                }
+                mPendingSampleTableCount = mPendingSampleTables.size();
+                mLazyMovieBox            = std::move(moovPtr);
+            }
         }
 
         return error;
@@ -700,8 +812,9 @@ namespace HEIF
 
             if (!trackInfo.samples.empty())
             {
-                auto sampleDataEndOffset = static_cast<int64_t>(trackInfo.samples.rbegin()->dataOffset +
-                                                                trackInfo.samples.rbegin()->dataLength);
+                const std::size_t lastIndex = trackInfo.samples.size() - 1;
+                auto sampleDataEndOffset    = static_cast<int64_t>(trackInfo.samples.dataOffset(lastIndex) +
+                                                                trackInfo.samples.dataLength(lastIndex));
                 if (sampleDataEndOffset > io.size || sampleDataEndOffset < 0)
                 {
                     throw RuntimeError(
@@ -821,7 +934,9 @@ namespace HEIF
 
         try
         {
-            while ((error == ErrorCode::OK) && !io.stream->peekEof())       // 循环读取heif图对应的bitStream
+            // A header-only read is done once the root level 'meta' has been parsed.
+            while ((error == ErrorCode::OK) && !(mHeaderOnly && metaFound) &&
+                   !io.stream->peekEof())       // 循环读取heif图对应的bitStream
             {
                 String boxType;
                 std::int64_t boxSize = 0;
@@ -864,8 +979,19 @@ namespace HEIF
                             break;
                         }
                         moovFound = true;
-                        addSegmentSequence(0, mNextSequence);
-                        error = handleMoov(io);
+                        if (mHeaderOnly)
+                        {
+                            error = skipBox(io);
+                        }
+                        else
+                        {
+                            addSegmentSequence(0, mNextSequence);
+                            error = handleMoov(io);
+                        }
+                    }
+                    else if (boxType == "moof" && mHeaderOnly)
+                    {
+                        error = skipBox(io);
                     }
                     else if (boxType == "moof")                 // moof：movie fragment box
                     {
@@ -873,9 +999,10 @@ namespace HEIF
                         const SegmentId initializationSegmentId = 0;
                         error                                   = handleInitSegmentMoof(io, initializationSegmentId);
                     }
-                    else if (boxType == "mdat" || boxType == "free" || boxType == "skip")
+                    else if (boxType == "mdat" || boxType == "free" || boxType == "skip" || boxType == "sidx")
                     {
-                        // skip 'mdat' as it is handled elsewhere, 'free' can be skipped
+                        // skip 'mdat' as it is handled elsewhere, 'free' can be skipped, 'sidx' of fragments in the
+                        // same file is not needed as all 'moof' boxes are read
                         error = skipBox(io);
                     }
                     else
@@ -930,7 +1057,7 @@ namespace HEIF
             const ItemInfoEntry& item = metaBox.getItemInfoBox().getItemById(itemId);
             ItemInfo itemInfo         = makeItemInfo(item);
 
-            if (isImageItem(makeItemInfo(item)))
+            if (isImageItem(itemInfo))
             {
                 const ItemPropertiesBox& iprp = metaBox.getItemPropertiesBox();
                 const std::uint32_t ispeIndex = iprp.findPropertyIndex(ItemPropertiesBox::PropertyType::ISPE, itemId);
@@ -1044,15 +1171,29 @@ namespace HEIF
             return error;
         }
 
+        const char* mappedData = io.stream->data();
+        if (mappedData != nullptr && io.size > 0)
+        {
+            // Parse the box in place from the memory mapped stream; readBoxParameters() checked it fits the stream.
+            const std::int64_t startLocation = io.stream->tell();
+            bitstream = BitStream(reinterpret_cast<const std::uint8_t*>(mappedData) + startLocation,
+                                  static_cast<std::uint64_t>(boxSize));
+            seekInput(io, startLocation + boxSize);
+            if (!io.stream->good())
+            {
+                return ErrorCode::FILE_READ_ERROR;
+            }
+            return ErrorCode::OK;
+        }
+
+        // Read the box straight into the storage which the bitstream then adopts, so it is not copied again.
         Vector<uint8_t> data(static_cast<std::uint64_t>(boxSize));
         io.stream->read(reinterpret_cast<char*>(data.data()), boxSize);
         if (!io.stream->good())
         {
             return ErrorCode::FILE_READ_ERROR;
         }
-        bitstream.clear();
-        bitstream.reset();
-        bitstream.write8BitsArray(data, std::uint64_t(boxSize));
+        bitstream = BitStream(std::move(data));
         return ErrorCode::OK;
     }
 
@@ -1179,6 +1320,10 @@ namespace HEIF
         {
             return error;
         }
+        if ((error = loadSampleTable(sequenceId)) != ErrorCode::OK)
+        {
+            return error;
+        }
 
         samples.clear();
         for (const auto& segment : segmentsBySequence())
@@ -1188,10 +1333,11 @@ namespace HEIF
 
             if (hasTrackInfo(segTrackId))
             {
-                samples.reserve(getTrackInfo(segTrackId).samples.size());
-                for (const auto& sampleInfo : getTrackInfo(segTrackId).samples)
+                const SampleTable& sampleTable = getTrackInfo(segTrackId).samples;
+                samples.reserve(samples.size() + sampleTable.size());
+                for (std::size_t index = 0; index < sampleTable.size(); ++index)
                 {
-                    samples.push_back(sampleInfo.sampleId);
+                    samples.push_back(sampleTable.sampleId(index));
                 }
             }
         }
@@ -1200,18 +1346,14 @@ namespace HEIF
 
     ErrorCode HeifReaderImpl::getProtection(const ImageId itemId, bool& isProtected) const
     {
-        ItemInfoEntry entry;
-        try
-        {
-            entry = mMetaBox.getItemInfoBox().getItemById(itemId.get());
-        }
-        catch (...)
+        const ItemInfoEntry* entry = mMetaBox.getItemInfoBox().findItemById(itemId.get());
+        if (entry == nullptr)
         {
             return ErrorCode::INVALID_ITEM_ID;
         }
 
         isProtected = false;
-        if (entry.getItemProtectionIndex() > 0)
+        if (entry->getItemProtectionIndex() > 0)
         {
             isProtected = true;
         }
@@ -1220,53 +1362,18 @@ namespace HEIF
 
     ErrorCode HeifReaderImpl::processAvcItemData(uint8_t* memoryBuffer, uint64_t& memoryBufferSize)
     {
-        uint32_t outputOffset = 0;
-        uint32_t byteOffset   = 0;
-
-        while (outputOffset < memoryBufferSize)
-        {
-            uint32_t nalLength                      = memoryBuffer[outputOffset + byteOffset];
-            memoryBuffer[outputOffset + byteOffset] = 0;
-            byteOffset++;
-            nalLength                               = (nalLength << 8) | memoryBuffer[outputOffset + byteOffset];
-            memoryBuffer[outputOffset + byteOffset] = 0;
-            byteOffset++;
-            nalLength                               = (nalLength << 8) | memoryBuffer[outputOffset + byteOffset];
-            memoryBuffer[outputOffset + byteOffset] = 0;
-            byteOffset++;
-            nalLength                               = (nalLength << 8) | memoryBuffer[outputOffset + byteOffset];
-            memoryBuffer[outputOffset + byteOffset] = 1;
-            // byteOffset++;
-            // AvcNalUnitType naluType = AvcNalUnitType((uint8_t)memoryBuffer[outputOffset + byteOffset] & 0x1f);
-            outputOffset += nalLength + 4;  // 4 bytes of nal length information
-            byteOffset = 0;
+        if (!convertLengthFieldsToStartCodes(memoryBuffer, memoryBufferSize))
+        {
+            return ErrorCode::MEDIA_PARSING_ERROR;
         }
         return ErrorCode::OK;
     }
 
     ErrorCode HeifReaderImpl::processHevcItemData(uint8_t* memoryBuffer, uint64_t& memoryBufferSize)
     {
-        uint32_t outputOffset = 0;
-        uint32_t byteOffset   = 0;
-
-        while (outputOffset < memoryBufferSize)
-        {
-            uint32_t nalLength                      = memoryBuffer[outputOffset + byteOffset];
-            memoryBuffer[outputOffset + byteOffset] = 0;
-            byteOffset++;
-            nalLength                               = (nalLength << 8) | memoryBuffer[outputOffset + byteOffset];
-            memoryBuffer[outputOffset + byteOffset] = 0;
-            byteOffset++;
-            nalLength                               = (nalLength << 8) | memoryBuffer[outputOffset + byteOffset];
-            memoryBuffer[outputOffset + byteOffset] = 0;
-            byteOffset++;
-            nalLength                               = (nalLength << 8) | memoryBuffer[outputOffset + byteOffset];
-            memoryBuffer[outputOffset + byteOffset] = 1;
-            // byteOffset++;
-            // HevcNalUnitType naluType = HevcNalUnitType(((uint8_t)memoryBuffer[outputOffset + byteOffset] >> 1) &
-            // 0x3f);
-            outputOffset += nalLength + 4;  // 4 bytes of nal length information
-            byteOffset = 0;
+        if (!convertLengthFieldsToStartCodes(memoryBuffer, memoryBufferSize))
+        {
+            return ErrorCode::MEDIA_PARSING_ERROR;
         }
         return ErrorCode::OK;
     }
@@ -1283,17 +1390,13 @@ namespace HEIF
             return error;
         }
 
-        ItemInfoEntry item;
-        try
-        {
-            item = mMetaBox.getItemInfoBox().getItemById(imageId.get());
-        }
-        catch (...)
+        const ItemInfoEntry* item = mMetaBox.getItemInfoBox().findItemById(imageId.get());
+        if (item == nullptr)
         {
             return ErrorCode::INVALID_ITEM_ID;
         }
 
-        if (isImageItem(makeItemInfo(item)))
+        if (isImageItem(*item))
         {
             return ErrorCode::OK;
         }
@@ -1307,11 +1410,7 @@ namespace HEIF
         {
             return error;
         }
-        try
-        {
-            mMetaBox.getItemInfoBox().getItemById(imageId.get()).getItemType();
-        }
-        catch (...)
+        if (mMetaBox.getItemInfoBox().findItemById(imageId.get()) == nullptr)
         {
             return ErrorCode::INVALID_ITEM_ID;
         }
@@ -1409,7 +1508,7 @@ namespace HEIF
             const ItemInfoEntry& item = metaBox.getItemInfoBox().getItemById(itemId);
 
             ItemFeature itemFeatures;
-            if (isImageItem(makeItemInfo(item)))
+            if (isImageItem(item))
             {
                 // 判断某个item是否应用了数据版权管理DRM或加密措施，主要用于付费图库、数字出版物等
                 if (item.getItemProtectionIndex() > 0)
@@ -1748,8 +1847,6 @@ namespace HEIF
     {
         const auto& io = mFileProperties.segmentPropertiesMap.at(0).io;
 
-        const streampos oldPosition = io.stream->tell();
-
         uint64_t itemLength(0);
         List<ImageId> pastReferences;
         ErrorCode error = getItemLength(metaBox, itemId, itemLength, pastReferences);
@@ -1765,9 +1862,7 @@ namespace HEIF
         data.resize(itemLength);
 
         uint8_t* dataPtr = data.data();
-        error            = readItem(metaBox, itemId, dataPtr, itemLength);
-        io.stream->seek(oldPosition);
-        return error;
+        return readItem(metaBox, itemId, dataPtr, itemLength);
     }
 
     ErrorCode HeifReaderImpl::getItemLength(const MetaBox& metaBox,
@@ -1912,17 +2007,12 @@ namespace HEIF
             for (const auto& extent : extentList)
             {
                 const auto offset = static_cast<std::int64_t>(baseOffset + extent.mExtentOffset);
-                io.stream->seek(offset);
-                if (!io.stream->good())
-                {
-                    return ErrorCode::FILE_READ_ERROR;
-                }
                 if (totalLenght + extent.mExtentLength > maxSize)
                 {
                     return ErrorCode::FILE_READ_ERROR;
                 }
-                io.stream->read(reinterpret_cast<char*>(memoryBuffer), std::streamsize(extent.mExtentLength));
-                if (!io.stream->good())
+                if (!io.stream->readAt(offset, reinterpret_cast<char*>(memoryBuffer),
+                                       static_cast<std::int64_t>(extent.mExtentLength)))
                 {
                     return ErrorCode::FILE_READ_ERROR;
                 }
@@ -2035,18 +2125,6 @@ namespace HEIF
     /* *********************** Track-specific methods  *********************** */
     /* *********************************************************************** */
 
-    void HeifReaderImpl::updateDecoderCodeTypeMap(const SamplePropertyVector& sampleInfo,
-                                                  WriteOnceMap<SequenceImageId, FourCCInt>& decoderCodeTypeMap,
-                                                  std::size_t prevSampleInfoSize)
-    {
-        for (std::size_t sampleIndex = prevSampleInfoSize; sampleIndex < sampleInfo.size(); ++sampleIndex)
-        {
-            const auto& info = sampleInfo[sampleIndex];
-            decoderCodeTypeMap.insert(
-                std::make_pair(info.sampleId, info.sampleEntryType));  // Store decoder type for track data decoding
-        }
-    }
-
     ErrorCode HeifReaderImpl::isValidTrack(const SequenceId& sequenceId) const
     {
         ErrorCode error;
@@ -2054,11 +2132,15 @@ namespace HEIF
         {
             return error;
         }
-        if (mFileProperties.initTrackInfos.count(sequenceId) != 0)
+        if (mFileProperties.initTrackInfos.count(sequenceId) == 0)
         {
-            return ErrorCode::OK;
+            return ErrorCode::INVALID_SEQUENCE_ID;
+        }
+        if (hasFailedSampleTable(sequenceId))
+        {
+            return ErrorCode::FILE_HEADER_ERROR;
         }
-        return ErrorCode::INVALID_SEQUENCE_ID;
+        return ErrorCode::OK;
     }
 
     ErrorCode HeifReaderImpl::isValidSample(const SequenceId& sequenceId, const SequenceImageId& sequenceImageId) const
@@ -2091,8 +2173,16 @@ namespace HEIF
             SequenceId sequenceId       = trackBox->getTrackHeaderBox().getTrackID();
             const auto& trackInfo       = segmentPropertiesMap.at(segmentId).trackInfos.at(sequenceId);
 
-            std::uint64_t maxSampleSize = 0;
-            makeSamplePropertyVector(trackBox, maxSampleSize);  //  discard return value, just get max sample size
+            // Take the maximum directly from 'stsz' so that it is available without expanding the sample table.
+            const SampleSizeBox& stszBox =
+                trackBox->getMediaBox().getMediaInformationBox().getSampleTableBox().getSampleSizeBox();
+            const Vector<std::uint32_t>& sampleSizes = stszBox.getEntrySize();
+            const std::size_t sampleCount = std::min<std::size_t>(stszBox.getSampleCount(), sampleSizes.size());
+            std::uint64_t maxSampleSize   = 0;
+            for (std::size_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex)
+            {
+                maxSampleSize = std::max<std::uint64_t>(maxSampleSize, sampleSizes[sampleIndex]);
+            }
 
             fillSampleEntryMap(stsdBox, initTrackInfo);
 
@@ -2139,25 +2229,24 @@ namespace HEIF
 
     void HeifReaderImpl::fillSegmentPropertiesMap(SegmentId segmentId,
                                                   const MovieBox& moovBox,
-                                                  SegmentPropertiesMap& segmentPropertiesMap)
+                                                  SegmentPropertiesMap& segmentPropertiesMap,
+                                                  const bool expandSampleTables)
     {
         const Vector<UniquePtr<TrackBox>>& trackBoxes = moovBox.getTrackBoxes();
         for (const auto& trackBoxP : trackBoxes)
         {
             const TrackBox* trackBox = trackBoxP.get();
             TrackInfoInSegment trackInfo =
-                createTrackInfoInSegment(trackBox, moovBox.getMovieHeaderBox().getTimeScale());
+                createTrackInfoInSegment(trackBox, moovBox.getMovieHeaderBox().getTimeScale(), expandSampleTables);
             SequenceId sequenceId = trackBox->getTrackHeaderBox().getTrackID();
 
-            std::uint64_t maxSampleSize = 0;
-            trackInfo.samples           = makeSamplePropertyVector(trackBox, maxSampleSize);
-
-            updateSampleToParametersSetMap(segmentPropertiesMap[segmentId].sampleToParameterSetMap, sequenceId,
-                                           trackInfo.samples);
-
-            updateDecoderCodeTypeMap(trackInfo.samples, trackInfo.decoderCodeTypeMap);
+            if (expandSampleTables)
+            {
+                std::uint64_t maxSampleSize = 0;
+                trackInfo.samples           = makeSampleTable(trackBox, maxSampleSize);
+            }
 
-            segmentPropertiesMap[segmentId].trackInfos[sequenceId] = trackInfo;
+            segmentPropertiesMap[segmentId].trackInfos[sequenceId] = std::move(trackInfo);
         }
     }
 
@@ -2564,7 +2653,9 @@ namespace HEIF
         return initTrackInfo;
     }
 
-    TrackInfoInSegment HeifReaderImpl::createTrackInfoInSegment(const TrackBox* trackBox, const uint32_t movieTimescale)
+    TrackInfoInSegment HeifReaderImpl::createTrackInfoInSegment(const TrackBox* trackBox,
+                                                                const uint32_t movieTimescale,
+                                                                const bool expandPresentationTimes)
     {
         TrackInfoInSegment trackInfo;
 
@@ -2587,15 +2678,21 @@ namespace HEIF
             const EditListBox* editListBox = editBox->getEditListBox();
             decodePts.loadBox(editListBox, movieTimescale, mediaTimeScale);
         }
-        if (!decodePts.unravel())
+        // Without an edit list the span does not depend on the per-sample presentation times, so building them can
+        // be left to makePresentationTimes().
+        const bool expandTimes = expandPresentationTimes || editBox != nullptr;
+        if (!(expandTimes ? decodePts.unravel() : decodePts.unravelSpan()))
         {
             throw FileReaderException(ErrorCode::FILE_HEADER_ERROR);
         }
 
         // Always generate track duration regardless of the information in the header
         trackInfo.durationTS = DecodePts::PresentationTimeTS(decodePts.getSpan());
-        trackInfo.pMap       = decodePts.getTime(mediaTimeScale);
-        trackInfo.pMapTS     = decodePts.getTimeTS();
+        if (expandTimes)
+        {
+            trackInfo.pMap   = decodePts.getTime(mediaTimeScale);
+            trackInfo.pMapTS = decodePts.getTimeTS();
+        }
 
         static const uint32_t DURATION_FROM_EDIT_LIST = 0xffffffff;
         if (tkhdDuration == DURATION_FROM_EDIT_LIST)
@@ -2665,10 +2762,27 @@ namespace HEIF
         return trackInfo;
     }
 
-    SamplePropertyVector HeifReaderImpl::makeSamplePropertyVector(const TrackBox* trackBox,
-                                                                  std::uint64_t& maxSampleSize)
+    void HeifReaderImpl::makePresentationTimes(const TrackBox* trackBox, TrackInfoInSegment& trackInfo)
     {
-        SamplePropertyVector sampleInfoVector;
+        const SampleTableBox& stblBox = trackBox->getMediaBox().getMediaInformationBox().getSampleTableBox();
+        std::shared_ptr<const CompositionOffsetBox> compositionOffsetBox = stblBox.getCompositionOffsetBox();
+
+        DecodePts decodePts;
+        decodePts.loadBox(&stblBox.getTimeToSampleBox());
+        decodePts.loadBox(compositionOffsetBox.get());
+        if (!decodePts.unravel())
+        {
+            throw FileReaderException(ErrorCode::FILE_HEADER_ERROR);
+        }
+
+        const uint32_t mediaTimeScale = trackBox->getMediaBox().getMediaHeaderBox().getTimeScale();
+        trackInfo.pMap                = decodePts.getTime(mediaTimeScale);
+        trackInfo.pMapTS              = decodePts.getTimeTS();
+    }
+
+    SampleTable HeifReaderImpl::makeSampleTable(const TrackBox* trackBox, std::uint64_t& maxSampleSize)
+    {
+        SampleTable sampleInfoVector;
 
         const SampleTableBox& stblBox       = trackBox->getMediaBox().getMediaInformationBox().getSampleTableBox();
         const SampleDescriptionBox& stsdBox = stblBox.getSampleDescriptionBox();
@@ -2691,6 +2805,8 @@ namespace HEIF
             throw FileReaderException(ErrorCode::FILE_HEADER_ERROR);
         }
 
+        sampleInfoVector.reserve(sampleCount);
+
         std::uint32_t previousChunkIndex = 0;  // Index is 1-based so 0 will not be used.
         std::uint64_t maxSize            = 0;
         for (uint32_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex)
@@ -2720,7 +2836,8 @@ namespace HEIF
 
             if (chunkIndex == previousChunkIndex)
             {
-                sampleProperties.dataOffset = sampleInfoVector.back().dataOffset + sampleInfoVector.back().dataLength;
+                sampleProperties.dataOffset =
+                    sampleInfoVector.dataOffset(sampleIndex - 1) + sampleInfoVector.dataLength(sampleIndex - 1);
             }
             else
             {
@@ -2774,7 +2891,8 @@ namespace HEIF
             if (stblBox.hasSyncSampleBox())
             {
                 // will be filled later based on sync sample box.
-                sampleProperties.sampleType = OUTPUT_NON_REFERENCE_FRAME;
+                sampleProperties.sampleType                                  = OUTPUT_NON_REFERENCE_FRAME;
+                sampleProperties.sampleFlags.flags.sample_is_non_sync_sample = 1;
             }
             else
             {
@@ -2856,9 +2974,11 @@ namespace HEIF
             const Vector<std::uint32_t>& syncSamples = stblBox.getSyncSampleBox()->getSyncSampleIds();
             for (unsigned int i : syncSamples)
             {
-                std::uint32_t syncSample    = i - 1;
-                auto& sampleProperties      = sampleInfoVector.at(syncSample);
-                sampleProperties.sampleType = OUTPUT_REFERENCE_FRAME;
+                std::uint32_t syncSample = i - 1;
+                sampleInfoVector.setSampleType(syncSample, OUTPUT_REFERENCE_FRAME);
+                SampleFlags flags                     = sampleInfoVector.sampleFlags(syncSample);
+                flags.flags.sample_is_non_sync_sample = 0;
+                sampleInfoVector.setSampleFlags(syncSample, flags);
             }
         }
 
@@ -2872,11 +2992,10 @@ namespace HEIF
             {
                 if (sampleInfoVector.size() > static_cast<uint32_t>(i))
                 {
-                    sampleInfoVector.at(static_cast<uint32_t>(i)).sampleCompositionOffsetTs = offsets.at(i);
+                    sampleInfoVector.setSampleCompositionOffsetTs(i, offsets.at(i));
                     if (offsets.at(i) == min)
                     {
-                        sampleInfoVector.at(static_cast<uint32_t>(i)).sampleType =
-                            SampleType::NON_OUTPUT_REFERENCE_FRAME;
+                        sampleInfoVector.setSampleType(i, SampleType::NON_OUTPUT_REFERENCE_FRAME);
                     }
                 }
             }
@@ -2900,15 +3019,22 @@ namespace HEIF
 
     const TrackInfoInSegment& HeifReaderImpl::getTrackInfo(SegmentTrackId segTrackId) const
     {
+        loadSampleTable(segTrackId.second);
         return mFileProperties.segmentPropertiesMap.at(segTrackId.first).trackInfos.at(segTrackId.second);
     }
 
     HEIF::ErrorCode HeifReaderImpl::getSampleInfo(SequenceId sequenceId,
                                                   SequenceImageId sequenceImageId,
-                                                  SampleProperties& sampleInfo) const
+                                                  const SampleTable*& sampleTable,
+                                                  std::size_t& sampleIndex) const
     {
+        ErrorCode error = loadSampleTable(sequenceId);
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
         SegmentId segmentId;
-        ErrorCode error = segmentIdOf(sequenceId, sequenceImageId, segmentId);
+        error = segmentIdOf(sequenceId, sequenceImageId, segmentId);
         if (error != ErrorCode::OK)
         {
             return error;
@@ -2916,20 +3042,269 @@ namespace HEIF
         SegmentTrackId segTrackId = std::make_pair(segmentId, sequenceId);
 
         SequenceImageId sampleBase;
-        const auto& sampleInfoVector = getSampleInfo(segTrackId, sampleBase);
-        sampleInfo                   = sampleInfoVector.at(sequenceImageId.get() - sampleBase.get());
+        sampleTable = &getSampleInfo(segTrackId, sampleBase);
+        sampleIndex = sequenceImageId.get() - sampleBase.get();
 
         return ErrorCode::OK;
     }
 
-    const SamplePropertyVector& HeifReaderImpl::getSampleInfo(SegmentTrackId segTrackId,
-                                                              SequenceImageId& sampleBase) const
+    const SampleTable& HeifReaderImpl::getSampleInfo(SegmentTrackId segTrackId, SequenceImageId& sampleBase) const
     {
+        loadSampleTable(segTrackId.second);
         const auto& segmentProperties = mFileProperties.segmentPropertiesMap.at(segTrackId.first);
         sampleBase                    = getTrackInfo(segTrackId).itemIdBase;
         return segmentProperties.trackInfos.at(segTrackId.second).samples;
     }
 
+    ErrorCode HeifReaderImpl::loadSampleTable(const SequenceId sequenceId) const
+    {
+        if (mPendingSampleTableCount.load(std::memory_order_acquire) == 0)
+        {
+            return ErrorCode::OK;
+        }
+
+        std::lock_guard<std::mutex> lock(mSampleTableMutex);
+        const auto pending = mPendingSampleTables.find(sequenceId);
+        if (pending == mPendingSampleTables.end())
+        {
+            return ErrorCode::OK;
+        }
+        if (pending->second.failed)
+        {
+            return ErrorCode::FILE_HEADER_ERROR;
+        }
+
+        const SegmentId initializationSegmentId = 0;
+        // Expanding the table does not change the observable state of the reader, only its cost.
+        auto& trackInfo = const_cast<TrackInfoInSegment&>(
+            mFileProperties.segmentPropertiesMap.at(initializationSegmentId).trackInfos.at(sequenceId));
+        ErrorCode error = ErrorCode::OK;
+        try
+        {
+            std::uint64_t maxSampleSize = 0;
+            trackInfo.samples           = makeSampleTable(pending->second.trackBox, maxSampleSize);
+            if (!trackInfo.hasEditList)
+            {
+                // Left for the expansion by createTrackInfoInSegment().
+                makePresentationTimes(pending->second.trackBox, trackInfo);
+            }
+            if (trackInfo.pMap.size() != 0u)
+            {
+                trackInfo.samples.appendCompositionTimes(trackInfo.pMap, trackInfo.pMapTS);
+            }
+        }
+        catch (const ISOBMFF::Exception& exc)
+        {
+            logError() << "loadSampleTable Exception Error: " << exc.what() << std::endl;
+            error = ErrorCode::FILE_HEADER_ERROR;
+        }
+        catch (const std::exception& e)
+        {
+            logError() << "loadSampleTable Exception Error: " << e.what() << std::endl;
+            error = ErrorCode::FILE_HEADER_ERROR;
+        }
+        if (error != ErrorCode::OK)
+        {
+            // Kept pending, so that the track is not mistaken for a valid track without samples.
+            trackInfo.samples      = SampleTable();
+            pending->second.failed = true;
+            return error;
+        }
+
+        mPendingSampleTables.erase(pending);
+        mPendingSampleTableCount.store(mPendingSampleTables.size(), std::memory_order_release);
+        return ErrorCode::OK;
+    }
+
+    ErrorCode HeifReaderImpl::loadSampleTables() const
+    {
+        if (mPendingSampleTableCount.load(std::memory_order_acquire) == 0)
+        {
+            return ErrorCode::OK;
+        }
+
+        Vector<SequenceId> sequenceIds;
+        {
+            std::lock_guard<std::mutex> lock(mSampleTableMutex);
+            for (const auto& pending : mPendingSampleTables)
+            {
+                sequenceIds.push_back(pending.first);
+            }
+        }
+        ErrorCode result = ErrorCode::OK;
+        for (const auto sequenceId : sequenceIds)
+        {
+            const ErrorCode error = loadSampleTable(sequenceId);
+            if (result == ErrorCode::OK)
+            {
+                result = error;
+            }
+        }
+        return result;
+    }
+
+    bool HeifReaderImpl::hasFailedSampleTable(const SequenceId sequenceId) const
+    {
+        if (mPendingSampleTableCount.load(std::memory_order_acquire) == 0)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mSampleTableMutex);
+        const auto pending = mPendingSampleTables.find(sequenceId);
+        return pending != mPendingSampleTables.end() && pending->second.failed;
+    }
+
+    const TrackBox* HeifReaderImpl::getPendingTrackBox(const SegmentTrackId segTrackId) const
+    {
+        if (segTrackId.first != 0 || mPendingSampleTableCount.load(std::memory_order_acquire) == 0)
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(mSampleTableMutex);
+        const auto pending = mPendingSampleTables.find(segTrackId.second);
+        return pending != mPendingSampleTables.end() && !pending->second.failed ? pending->second.trackBox : nullptr;
+    }
+
+    const HeifReaderImpl::SeekIndex& HeifReaderImpl::getSeekIndex(const SequenceId sequenceId) const
+    {
+        const auto existing = mSeekIndexes.find(sequenceId);
+        if (existing != mSeekIndexes.end())
+        {
+            return existing->second;
+        }
+
+        SeekIndex& seekIndex = mSeekIndexes[sequenceId];
+        Vector<std::pair<std::int64_t, std::uint32_t>> timeSamples;
+        for (const auto& segment : segmentsBySequence())
+        {
+            const SegmentTrackId segTrackId = std::make_pair(segment.segmentId, sequenceId);
+            if (!hasTrackInfo(segTrackId))
+            {
+                continue;
+            }
+
+            SequenceImageId sampleBase;
+            const SampleTable& samples = getSampleInfo(segTrackId, sampleBase);
+            for (std::size_t index = 0; index < samples.size(); ++index)
+            {
+                const auto decodingIndex = static_cast<std::uint32_t>(seekIndex.samples.size());
+                seekIndex.samples.push_back(samples.sampleId(index));
+                if (samples.sampleFlags(index).flags.sample_is_non_sync_sample == 0)
+                {
+                    seekIndex.syncSamples.push_back(decodingIndex);
+                }
+                if (samples.sampleType(index) == SampleType::NON_OUTPUT_REFERENCE_FRAME)
+                {
+                    continue;
+                }
+                for (const auto compositionTime : samples.compositionTimes(index))
+                {
+                    timeSamples.push_back(std::make_pair(compositionTime, decodingIndex));
+                }
+            }
+        }
+
+        // Of samples displayed at the same time, the one decoded last is presented.
+        std::sort(timeSamples.begin(), timeSamples.end());
+        seekIndex.times.reserve(timeSamples.size());
+        seekIndex.timeSamples.reserve(timeSamples.size());
+        for (const auto& timeSample : timeSamples)
+        {
+            seekIndex.times.push_back(timeSample.first);
+            seekIndex.timeSamples.push_back(timeSample.second);
+        }
+        return seekIndex;
+    }
+
+    void HeifReaderImpl::clearSeekIndexes()
+    {
+        std::lock_guard<std::mutex> lock(mSeekIndexMutex);
+        mSeekIndexes.clear();
+    }
+
+    std::size_t HeifReaderImpl::getSampleCount(const SegmentTrackId segTrackId,
+                                               const TrackInfoInSegment& trackInfo) const
+    {
+        // The boxes of a pending table stay alive until reset(), even if the table gets expanded meanwhile.
+        if (const TrackBox* trackBox = getPendingTrackBox(segTrackId))
+        {
+            return trackBox->getMediaBox().getMediaInformationBox().getSampleTableBox().getSampleSizeBox().getSampleCount();
+        }
+        return trackInfo.samples.size();
+    }
+
+    ErrorCode HeifReaderImpl::getSampleLocation(const SegmentTrackId segTrackId,
+                                                const std::uint32_t sampleIndex,
+                                                std::uint64_t& dataOffset,
+                                                std::uint32_t& dataLength,
+                                                SampleDescriptionIndex& sampleDescriptionIndex) const
+    {
+        if (segTrackId.first == 0 && mPendingSampleTableCount.load(std::memory_order_acquire) != 0)
+        {
+            std::lock_guard<std::mutex> lock(mSampleTableMutex);
+            const auto pendingIterator = mPendingSampleTables.find(segTrackId.second);
+            if (pendingIterator != mPendingSampleTables.end() && pendingIterator->second.failed)
+            {
+                return ErrorCode::FILE_HEADER_ERROR;
+            }
+            if (pendingIterator != mPendingSampleTables.end())
+            {
+                // Resolve the sample directly from 'stsc', 'stco' and 'stsz' without expanding the whole table.
+                PendingSampleTable& pending   = pendingIterator->second;
+                const SampleTableBox& stblBox =
+                    pending.trackBox->getMediaBox().getMediaInformationBox().getSampleTableBox();
+                const SampleToChunkBox& stscBox         = stblBox.getSampleToChunkBox();
+                const Vector<uint64_t>& chunkOffsets    = stblBox.getChunkOffsetBox().getChunkOffsets();
+                const SampleSizeBox& stszBox            = stblBox.getSampleSizeBox();
+                const Vector<uint32_t>& sampleSizes     = stszBox.getEntrySize();
+
+                std::uint32_t chunkIndex         = 0;
+                std::uint32_t firstSampleInChunk = 0;
+                std::uint32_t descriptionIndex   = 0;
+                if (sampleIndex >= stszBox.getSampleCount())
+                {
+                    return ErrorCode::INVALID_SEQUENCE_IMAGE_ID;
+                }
+                if (sampleIndex >= sampleSizes.size() ||
+                    !stscBox.getSampleChunkIndex(sampleIndex, chunkIndex, firstSampleInChunk) ||
+                    !stscBox.getSampleDescriptionIndex(sampleIndex, descriptionIndex) || chunkIndex == 0 ||
+                    chunkIndex > chunkOffsets.size())
+                {
+                    return ErrorCode::FILE_HEADER_ERROR;
+                }
+
+                // Samples are usually read in order, so continue from the previous position within the same chunk.
+                if (pending.cursorChunkIndex != chunkIndex || pending.cursorSampleIndex > sampleIndex)
+                {
+                    pending.cursorChunkIndex  = chunkIndex;
+                    pending.cursorSampleIndex = firstSampleInChunk;
+                    pending.cursorDataOffset  = chunkOffsets[chunkIndex - 1];
+                }
+                for (; pending.cursorSampleIndex < sampleIndex; ++pending.cursorSampleIndex)
+                {
+                    pending.cursorDataOffset += sampleSizes[pending.cursorSampleIndex];
+                }
+
+                dataOffset             = pending.cursorDataOffset;
+                dataLength             = sampleSizes[sampleIndex];
+                sampleDescriptionIndex = descriptionIndex;
+                return ErrorCode::OK;
+            }
+        }
+
+        const auto& trackInfo = mFileProperties.segmentPropertiesMap.at(segTrackId.first).trackInfos.at(segTrackId.second);
+        if (sampleIndex >= trackInfo.samples.size())
+        {
+            return ErrorCode::INVALID_SEQUENCE_IMAGE_ID;
+        }
+        dataOffset             = trackInfo.samples.dataOffset(sampleIndex);
+        dataLength             = trackInfo.samples.dataLength(sampleIndex);
+        sampleDescriptionIndex = trackInfo.samples.sampleDescriptionIndex(sampleIndex);
+        return ErrorCode::OK;
+    }
+
     Vector<SequenceImageId> HeifReaderImpl::getSampleDirectDependencies(const SequenceImageId itemId,
                                                                         const SampleGroupDescriptionBox* sgpd,
                                                                         const SampleToGroupBox& sampleToGroupBox)
@@ -3024,7 +3399,7 @@ namespace HEIF
                 const auto& trackInfo = segmentProperties.trackInfos.at(trackId);
                 if (!trackInfo.samples.empty())
                 {
-                    nextItemIdBase = trackInfo.samples.rbegin()->sampleId.get() + 1;
+                    nextItemIdBase = trackInfo.samples.sampleId(trackInfo.samples.size() - 1).get() + 1;
                 }
                 else
                 {
@@ -3097,6 +3472,36 @@ namespace HEIF
         mFileProperties.sequenceToSegment.insert(std::make_pair(sequence, segmentId));
     }
 
+    void HeifReaderImpl::indexSegmentTrack(const SegmentId segmentId, const SequenceId sequenceId)
+    {
+        const SegmentProperties& segmentProperties = mFileProperties.segmentPropertiesMap.at(segmentId);
+        const auto trackInfo                       = segmentProperties.trackInfos.find(sequenceId);
+        if (segmentProperties.sequences.empty() || trackInfo == segmentProperties.trackInfos.end())
+        {
+            return;
+        }
+        const auto key = std::make_pair(trackInfo->second.itemIdBase, *segmentProperties.sequences.begin());
+        mFileProperties.sampleIdToSegment[sequenceId][key] = segmentId;
+    }
+
+    void HeifReaderImpl::unindexSegmentTrack(const SegmentId segmentId, const SequenceId sequenceId)
+    {
+        const SegmentProperties& segmentProperties = mFileProperties.segmentPropertiesMap.at(segmentId);
+        const auto trackInfo                       = segmentProperties.trackInfos.find(sequenceId);
+        const auto index                           = mFileProperties.sampleIdToSegment.find(sequenceId);
+        if (segmentProperties.sequences.empty() || trackInfo == segmentProperties.trackInfos.end() ||
+            index == mFileProperties.sampleIdToSegment.end())
+        {
+            return;
+        }
+        const auto entry =
+            index->second.find(std::make_pair(trackInfo->second.itemIdBase, *segmentProperties.sequences.begin()));
+        if (entry != index->second.end() && entry->second == segmentId)
+        {
+            index->second.erase(entry);
+        }
+    }
+
     void HeifReaderImpl::addToTrackProperties(SegmentId segmentId,
                                               MovieFragmentBox& moofBox,
                                               const SequenceIdPresentationTimeTSMap& earliestPTSTS)
@@ -3142,7 +3547,8 @@ namespace HEIF
             for (const auto trackRunBox : trackRunBoxes)
             {
                 SequenceImageId trackrunItemIdBase =
-                    !trackInfo.samples.empty() ? trackInfo.samples.back().sampleId.get() + 1 : segmentItemIdBase;
+                    !trackInfo.samples.empty() ? trackInfo.samples.sampleId(trackInfo.samples.size() - 1).get() + 1
+                                               : segmentItemIdBase;
                 // figure out what is the base data offset for the samples in this trun box:
                 std::uint64_t baseDataOffset = 0;
                 if ((trackFragmentBox->getTrackFragmentHeaderBox().getFlags() &
@@ -3180,38 +3586,23 @@ namespace HEIF
                 addSamplesToTrackInfo(trackInfo, mFileProperties, initTrackInfo, baseDataOffset, sampleDescriptionIndex,
                                       segmentItemIdBase, trackrunItemIdBase, trackRunBox);
             }
+            unindexSegmentTrack(segmentId, trackId);
             trackInfo.itemIdBase = segmentItemIdBase;
-            auto& decoderCodeTypeMap =
-                mFileProperties.segmentPropertiesMap.at(segmentId).trackInfos.at(trackId).decoderCodeTypeMap;
-            updateDecoderCodeTypeMap(trackInfo.samples, decoderCodeTypeMap, prevSampleInfoSize);
-            updateSampleToParametersSetMap(mFileProperties.segmentPropertiesMap[segmentId].sampleToParameterSetMap,
-                                           trackId, trackInfo.samples, prevSampleInfoSize);
+            indexSegmentTrack(segmentId, trackId);
 
             if (!trackInfo.samples.empty())
             {
                 // update sample data offset in case it is needed to read next track fragment data offsets (base offset
                 // not defined)
+                const std::size_t lastIndex = trackInfo.samples.size() - 1;
                 trackFragmentSampleDataOffset =
-                    trackInfo.samples.rbegin()->dataOffset + trackInfo.samples.rbegin()->dataLength;
+                    trackInfo.samples.dataOffset(lastIndex) + trackInfo.samples.dataLength(lastIndex);
             }
             firstTrackFragment = false;
         }
     }
 
 
-    void HeifReaderImpl::updateSampleToParametersSetMap(SampleToParameterSetMap& sampleToParameterSetMap,
-                                                        const SequenceId sequenceId,
-                                                        const SamplePropertyVector& sampleInfo,
-                                                        const std::size_t prevSampleInfoSize)
-    {
-        for (std::size_t sampleIndex = prevSampleInfoSize; sampleIndex < sampleInfo.size(); ++sampleIndex)
-        {
-            auto itemId            = SequenceImageIdPair(sequenceId, sampleIndex);
-            auto parameterSetMapId = sampleInfo[sampleIndex].sampleDescriptionIndex;
-            sampleToParameterSetMap.insert(std::make_pair(itemId, parameterSetMapId));
-        }
-    }
-
     void HeifReaderImpl::addSamplesToTrackInfo(TrackInfoInSegment& trackInfo,
                                                const FileInformationInternal& fileInformation,
                                                const InitTrackInfo& initTrackInfo,
@@ -3322,7 +3713,7 @@ namespace HEIF
 
         SegmentProperties& segmentProperties = mFileProperties.segmentPropertiesMap[segmentId];
         StreamIO& io                         = segmentProperties.io;
-        io.stream.reset(CUSTOM_NEW(InternalStream, (streamInterface)));
+        io.stream.reset(CUSTOM_NEW(InternalStream, (streamInterface, mReadAheadSize)));
         if (io.stream->peekEof())
         {
             mState = prevState;
@@ -3496,25 +3887,15 @@ namespace HEIF
         for (auto& trackTrackInfo : mFileProperties.segmentPropertiesMap.at(segmentId).trackInfos)
         {
             auto& trackInfo = trackTrackInfo.second;
+            if (segmentId == 0 && mPendingSampleTables.count(trackTrackInfo.first) != 0u)
+            {
+                // loadSampleTable() sets the composition times when the table is expanded.
+                continue;
+            }
             if (trackInfo.pMap.size() != 0u)
             {
                 // Set composition times from Pmap, which considers also edit lists
-                for (const auto& pair : trackInfo.pMap)
-                {
-                    if (pair.first < 0)  // negative time implies a hidden sample
-                    {
-                        continue;
-                    }
-                    trackInfo.samples.at(pair.second).compositionTimes.push_back(pair.first);
-                }
-                for (const auto& pair : trackInfo.pMapTS)
-                {
-                    if (pair.first < 0)  // negative time implies a hidden sample
-                    {
-                        continue;
-                    }
-                    trackInfo.samples.at(pair.second).compositionTimesTS.push_back(std::uint64_t(pair.first));
-                }
+                trackInfo.samples.appendCompositionTimes(trackInfo.pMap, trackInfo.pMapTS);
             }
         }
     }
@@ -3573,15 +3954,23 @@ namespace HEIF
         {
             return nullptr;
         }
-        const auto& segmentProperties  = mFileProperties.segmentPropertiesMap.at(segmentId);
-        const unsigned int sampleIndex = sampleId.get() - getTrackInfo({segmentId, sequenceId}).itemIdBase.get();
-        const auto& itemIndexIterator  = segmentProperties.sampleToParameterSetMap.find({sequenceId, sampleIndex});
-        if (itemIndexIterator != segmentProperties.sampleToParameterSetMap.end())
+        const SegmentTrackId segTrackId = std::make_pair(segmentId, sequenceId);
+        const auto& trackInfo  = mFileProperties.segmentPropertiesMap.at(segmentId).trackInfos.at(sequenceId);
+        const std::uint32_t sampleIndex = sampleId.get() - trackInfo.itemIdBase.get();
+
+        std::uint64_t dataOffset;
+        std::uint32_t dataLength;
+        SampleDescriptionIndex sampleDescriptionIndex;
+        if (getSampleLocation(segTrackId, sampleIndex, dataOffset, dataLength, sampleDescriptionIndex) != ErrorCode::OK)
         {
-            if (mFileProperties.initTrackInfos.at(sequenceId).parameterSetMaps.count(itemIndexIterator->second))
-            {
-                return &mFileProperties.initTrackInfos.at(sequenceId).parameterSetMaps.at(itemIndexIterator->second);
-            }
+            return nullptr;
+        }
+
+        const auto& parameterSetMaps = mFileProperties.initTrackInfos.at(sequenceId).parameterSetMaps;
+        const auto parameterSetMap   = parameterSetMaps.find(sampleDescriptionIndex);
+        if (parameterSetMap != parameterSetMaps.end())
+        {
+            return &parameterSetMap->second;
         }
 
         return nullptr;
@@ -3594,15 +3983,13 @@ namespace HEIF
 
     ErrorCode getRawItemType(const MetaBox& metaBox, const ImageId itemId, FourCCInt& type)
     {
-        try
-        {
-            type = metaBox.getItemInfoBox().getItemById(itemId.get()).getItemType();
-        }
-        catch (...)
+        const ItemInfoEntry* item = metaBox.getItemInfoBox().findItemById(itemId.get());
+        if (item == nullptr)
         {
             return ErrorCode::INVALID_ITEM_ID;
         }
 
+        type = item->getItemType();
         return ErrorCode::OK;
     }
 
@@ -3640,11 +4027,12 @@ namespace HEIF
 
     bool HeifReaderImpl::isImageItem(const ItemInfo& info)
     {
-        static const std::set<FourCCInt> IMAGE_TYPES = {"avc1", "hvc1", "grid", "iovl", "iden", "jpeg"};
-
-        auto type = info.type;
+        return isImageItemType(info.type, info.contentType);
+    }
 
-        return (IMAGE_TYPES.count(type) != 0u) || (type == "mime" && info.contentType == "image/jpeg");
+    bool HeifReaderImpl::isImageItem(const ItemInfoEntry& item)
+    {
+        return isImageItemType(item.getItemType(), item.getContentType());
     }
 
     HeifReaderImpl::ItemInfo HeifReaderImpl::makeItemInfo(const ItemInfoEntry& item)
@@ -3736,6 +4124,7 @@ namespace HEIF
     template Array<std::int32_t> makeArray(const Vector<std::int32_t>& container);
     template Array<std::uint32_t> makeArray(const Vector<std::uint32_t>& container);
     template Array<std::int64_t> makeArray(const Vector<std::int64_t>& container);
+    template Array<std::int64_t> makeArray(const SampleTable::Range<std::int64_t>& container);
     template Array<std::uint64_t> makeArray(const Vector<std::uint64_t>& container);
     template Array<std::uint8_t> makeArray(const Vector<std::uint8_t>& container);
     template Array<EditUnit> makeArray(const Vector<EditUnit>& container);
@@ -14,6 +14,9 @@
 #ifndef HEIFREADERIMPL_HPP
 #define HEIFREADERIMPL_HPP
 
+#include <atomic>
+#include <mutex>
+
 #include "decodepts.hpp"
 #include "extendedtypebox.hpp"
 #include "filetypebox.hpp"
@@ -41,12 +44,24 @@ namespace HEIF
         HeifReaderImpl();
         ~HeifReaderImpl() override = default;
 
+        /// @see Reader::setLazySampleTables()
+        ErrorCode setLazySampleTables(bool lazy) override;
+
+        /// @see Reader::setReadAheadSize()
+        ErrorCode setReadAheadSize(std::uint32_t size) override;
+
         /// @see Reader::initialize()
         ErrorCode initialize(const char* fileName) override;
 
         /// @see Reader::initialize()
         ErrorCode initialize(StreamInterface* stream) override;
 
+        /// @see Reader::probe()
+        ErrorCode probe(const char* fileName, ProbeInformation& probeInfo) override;
+
+        /// @see Reader::probe()
+        ErrorCode probe(StreamInterface* stream, ProbeInformation& probeInfo) override;
+
         /// @see Reader::close()
         void close() override;
 
@@ -65,6 +80,9 @@ namespace HEIF
         /// @see Reader::getFileInformation()
         ErrorCode getFileInformation(FileInformation& fileinfo) const override;
 
+        /// @see Reader::getFileInformation()
+        ErrorCode getFileInformation(const FileInformation*& fileinfo) const override;
+
         /// @see Reader::getDisplayWidth()
         ErrorCode getDisplayWidth(const SequenceId& sequenceId, uint32_t& displayWidth) const override;
 
@@ -136,6 +154,14 @@ namespace HEIF
                               uint64_t& memoryBufferSize,
                               bool bytestreamHeaders = true) override;
 
+        /// @see Reader::getItemDataBatch()
+        ErrorCode getItemDataBatch(const Array<ImageId>& imageIds,
+                                   Array<ItemDataBuffer>& buffers,
+                                   bool bytestreamHeaders = true) const override;
+
+        /// @see Reader::getItemDataView()
+        ErrorCode getItemDataView(const ImageId& itemId, const uint8_t*& data, uint64_t& dataSize) const override;
+
         /// @see Reader::getItem()
         ErrorCode getItem(const ImageId& itemId, Overlay& iovlItem) const override;
 
@@ -239,6 +265,11 @@ namespace HEIF
         /// @see Reader::getDecodeDependencies()
         ErrorCode getDecodeDependencies(const ImageId& imageId, Array<ImageId>& dependencies) const override;
 
+        /// @see Reader::getSeekSamples()
+        ErrorCode getSeekSamples(const SequenceId& sequenceId,
+                                 std::int64_t timestamp,
+                                 Array<SequenceImageId>& samples) const override;
+
         /// @see Reader::getDecoderCodeType()
         ErrorCode getDecoderCodeType(const ImageId& itemId, FourCC& type) const override;
 
@@ -323,6 +354,11 @@ namespace HEIF
         /** Reset reader internal state */
         void reset();
 
+        /** Reset the reader and parse the file from a stream.
+         *  @param [in] stream     Stream to read.
+         *  @param [in] headerOnly Parse only 'ftyp' and 'meta', see Reader::probe(). */
+        ErrorCode openStream(StreamInterface* stream, bool headerOnly);
+
         /** Parse input stream, fill mFileProperties and implementation internal data structures. */
         ErrorCode readStream();
 
@@ -399,6 +435,14 @@ namespace HEIF
          *  @return ErrorCode: OK, FILE_READ_ERROR */
         static ErrorCode processHevcItemData(uint8_t* memoryBuffer, uint64_t& memoryBufferSize);
 
+        /** Substitute nal-length values of 'hvc1'/'avc1' item data with bytestream headers.
+         *  Data of protected items and items of other types is left untouched.
+         *  @param [in]     itemId            Item id of the data.
+         *  @param [in,out] memoryBuffer      Item data.
+         *  @param [in,out] memoryBufferSize  Size of the item data.
+         *  @return ErrorCode: OK, INVALID_ITEM_ID, UNSUPPORTED_CODE_TYPE, FILE_READ_ERROR */
+        ErrorCode processItemData(const ImageId& itemId, uint8_t* memoryBuffer, uint64_t& memoryBufferSize) const;
+
         /* ********************************************************************** */
         /* *********************** Meta-specific section  *********************** */
         /* ********************************************************************** */
@@ -434,6 +478,11 @@ namespace HEIF
          * @return True if the 4CC is an image type or if it's a mime type and content type "image/jpeg" */
         static bool isImageItem(const ItemInfo& itemInfo);
 
+        /**
+         * @brief Same as isImageItem(const ItemInfo&), without building an ItemInfo for the entry first.
+         * @param item Item Information box entry of the item */
+        static bool isImageItem(const ItemInfoEntry& item);
+
         /**
          * @param imageId ImageId to check.
          * @return OK if itemId is a valid image item in the root-level meta box, INVALID_ITEM_ID if not.
@@ -568,6 +617,85 @@ namespace HEIF
         /** Given an init segment id and an item id find the segment id */
         ErrorCode segmentIdOf(SequenceId sequenceId, SequenceImageId itemId, SegmentId& segmentId) const;
 
+        /** Add the samples of a track in a segment to the index used by segmentIdOf(). */
+        void indexSegmentTrack(SegmentId segmentId, SequenceId sequenceId);
+
+        /** Remove the samples of a track in a segment from the index used by segmentIdOf(). Call before the sample id
+         *  base of the track in the segment changes, or the segment is removed. */
+        void unindexSegmentTrack(SegmentId segmentId, SequenceId sequenceId);
+
+        /** @brief Sample table of a track which has not been expanded yet, see Reader::setLazySampleTables(). */
+        struct PendingSampleTable
+        {
+            const TrackBox* trackBox;
+            // Cursor to the last located sample, so that sequential access does not rescan its chunk.
+            std::uint32_t cursorSampleIndex;
+            std::uint32_t cursorChunkIndex;
+            std::uint64_t cursorDataOffset;
+            bool failed;  ///< Expanding the table failed, the track is reported as invalid
+        };
+
+        bool mLazySampleTables;             ///< Leave sample tables of non-fragmented files to be expanded on demand
+        std::uint32_t mReadAheadSize;       ///< Read-ahead buffer size of the InternalStream objects
+        bool mHeaderOnly;                   ///< Only 'ftyp' and 'meta' are parsed, see Reader::probe()
+        UniquePtr<MovieBox> mLazyMovieBox;  ///< Keeps the boxes of pending sample tables alive
+
+        // Sample tables are expanded from const accessors, so the pending state is guarded by a mutex. The count
+        // allows skipping the lock once every table has been expanded.
+        mutable std::mutex mSampleTableMutex;
+        mutable std::atomic<std::size_t> mPendingSampleTableCount;
+        mutable Map<SequenceId, PendingSampleTable> mPendingSampleTables;  ///< Only for the initialization segment
+
+        /** Expand the sample table of the track if it is pending. Safe to call concurrently.
+         *  @return FILE_HEADER_ERROR if the table of the track could not be expanded, now or on an earlier call. */
+        ErrorCode loadSampleTable(SequenceId sequenceId) const;
+
+        /** Expand every pending sample table.
+         *  @return The first error of loadSampleTable(). */
+        ErrorCode loadSampleTables() const;
+
+        /** @return True if expanding the sample table of the track has failed. */
+        bool hasFailedSampleTable(SequenceId sequenceId) const;
+
+        /** @brief Index of a track for locating the samples to decode for a display time, see getSeekSamples(). */
+        struct SeekIndex
+        {
+            Vector<SequenceImageId> samples;    ///< Samples of the track in decoding order
+            Vector<std::uint32_t> syncSamples;  ///< Decoding order indices of the sync samples, ascending
+            Vector<std::int64_t> times;         ///< Display timestamps in milliseconds, ascending
+            Vector<std::uint32_t> timeSamples;  ///< Decoding order index of the sample displayed at each timestamp
+        };
+
+        // Seek indexes are built from const accessors on first use, and dropped when the segments change.
+        mutable std::mutex mSeekIndexMutex;
+        mutable Map<SequenceId, SeekIndex> mSeekIndexes;
+
+        /** @return Seek index of the track, built on first use. The caller must hold mSeekIndexMutex while it is used,
+         *          as clearSeekIndexes() may drop it. */
+        const SeekIndex& getSeekIndex(SequenceId sequenceId) const;
+
+        /** Drop the seek indexes after the samples of the tracks have changed. */
+        void clearSeekIndexes();
+
+        /** @return Track box of a pending sample table, or nullptr if the table of the track has been expanded. */
+        const TrackBox* getPendingTrackBox(SegmentTrackId segTrackId) const;
+
+        /** @return Number of samples of the track in the segment, without expanding a pending sample table. */
+        std::size_t getSampleCount(SegmentTrackId segTrackId, const TrackInfoInSegment& trackInfo) const;
+
+        /**
+         * @brief Locate a sample of a track in the segment without expanding a pending sample table.
+         * @param [in]  sampleIndex            Index of the sample in the segment
+         * @param [out] dataOffset             File offset of the sample data
+         * @param [out] dataLength             Length of the sample data
+         * @param [out] sampleDescriptionIndex Sample description entry of the sample
+         * @return ErrorCode: OK, INVALID_SEQUENCE_IMAGE_ID or FILE_HEADER_ERROR */
+        ErrorCode getSampleLocation(SegmentTrackId segTrackId,
+                                    std::uint32_t sampleIndex,
+                                    std::uint64_t& dataOffset,
+                                    std::uint32_t& dataLength,
+                                    SampleDescriptionIndex& sampleDescriptionIndex) const;
+
         /// Next Sequence number replacing  for surviving through non-linearities in
         /// MovieFragmentHeader.FragmentSequenceNumber
         Sequence mNextSequence = {};
@@ -580,29 +708,9 @@ namespace HEIF
         const TrackInfoInSegment& getTrackInfo(SegmentTrackId segTrackId) const;
         HEIF::ErrorCode getSampleInfo(SequenceId sequenceId,
                                       SequenceImageId sequenceImageId,
-                                      SampleProperties& sampleInfo) const;
-        const SamplePropertyVector& getSampleInfo(SegmentTrackId segTrackId, SequenceImageId& sampleBase) const;
-
-        /**
-         * @brief Update mDecoderCodeTypeMap to include the data from the samples
-         * @param [in] SampleInfoVector sampleInfo Samples to traverse
-         */
-        static void updateDecoderCodeTypeMap(const SamplePropertyVector& sampleInfo,
-                                             WriteOnceMap<SequenceImageId, FourCCInt>& decoderCodeTypeMap,
-                                             std::size_t prevSampleInfoSize = 0);
-
-        /**
-         * @brief Update given SampleToParameterSetMap
-         * @param [out] sampleToParameterSetMap Map where parameters are added
-         * @param [in] sequenceId              Sequence/track ID
-         * @param [in] sampleToParameterSetMap Samples to traverse
-         * @param [in] size_t prevSampleInfoSize Index to start interating on (to avoid duplicate work on consecutive
-         * moofs)
-         */
-        static void updateSampleToParametersSetMap(SampleToParameterSetMap& sampleToParameterSetMap,
-                                                   SequenceId initSegTrackId,
-                                                   const SamplePropertyVector& sampleInfo,
-                                                   size_t prevSampleInfoSize = 0);
+                                      const SampleTable*& sampleTable,
+                                      std::size_t& sampleIndex) const;
+        const SampleTable& getSampleInfo(SegmentTrackId segTrackId, SequenceImageId& sampleBase) const;
 
         /**
          * @brief Add samples to a addToTrackInfo for the reader interface
@@ -681,10 +789,12 @@ namespace HEIF
          * @brief Create a TrackInfoInSegment map struct for the reader interface internal usage.
          * @param [in] segmentId Segment id.
          * @param [in] moovBox MovieBox to extract properties from
+         * @param [in] expandSampleTables False to leave sample tables empty for loadSampleTable()
          * @return Filled TrackPropertiesMap */
         static void fillSegmentPropertiesMap(SegmentId segmentId,
                                              const MovieBox& moovBox,
-                                             SegmentPropertiesMap& segmentPropertiesMap);
+                                             SegmentPropertiesMap& segmentPropertiesMap,
+                                             bool expandSampleTables = true);
 
         /**
          * @brief Create a MoovProperties struct for the reader interface
@@ -784,15 +894,25 @@ namespace HEIF
          * @brief Extract reader internal TrackInfoInSegment structure from TrackBox
          * @param [in] trackBox        TrackBox to extract data from
          * @param [in] movieTimescale  Time scale of the MovieBox containing the TrackBox
+         * @param [in] expandPresentationTimes False to leave pMap and pMapTS of tracks without an edit list empty for
+         *                                     makePresentationTimes()
          * @return Filled TrackInfoInSegment struct */
-        static TrackInfoInSegment createTrackInfoInSegment(const TrackBox* trackBox, uint32_t movieTimescale);
+        static TrackInfoInSegment createTrackInfoInSegment(const TrackBox* trackBox,
+                                                           uint32_t movieTimescale,
+                                                           bool expandPresentationTimes = true);
+
+        /**
+         * @brief Fill pMap and pMapTS of a track without an edit list, left empty by createTrackInfoInSegment()
+         * @param [in] trackBox        TrackBox to extract data from
+         * @param [out] trackInfo      TrackInfoInSegment of the track */
+        static void makePresentationTimes(const TrackBox* trackBox, TrackInfoInSegment& trackInfo);
 
         /**
          * @brief Extract reader internal information about samples
          * @param trackBox [in] trackBox TrackBox to extract data from
          * @param maxSampleSize max size of samples for track.
-         * @return SamplePropertyVector containing information about every sample of the track */
-        static SamplePropertyVector makeSamplePropertyVector(const TrackBox* trackBox, std::uint64_t& maxSampleSize);
+         * @return SampleTable containing information about every sample of the track */
+        static SampleTable makeSampleTable(const TrackBox* trackBox, std::uint64_t& maxSampleSize);
 
         /**
          * @brief Add sample decoding dependencies
@@ -13,6 +13,11 @@
 
 #include "heifstreamfile.hpp"
 
+#if !(defined(_WIN32) || defined(_WIN64))
+#include <errno.h>
+#include <unistd.h>
+#endif
+
 #include "customallocator.hpp"
 
 
@@ -109,6 +114,36 @@ namespace HEIF
         }
     }
 
+    FileStream::offset_t FileStream::readAt(offset_t offset, char* buffer, offset_t size_)
+    {
+#if defined(_WIN32) || defined(_WIN64)
+        return StreamInterface::readAt(offset, buffer, size_);
+#else
+        if (!m_file)
+        {
+            return 0;
+        }
+
+        // pread() on the underlying descriptor leaves both the descriptor and the FILE buffer position untouched.
+        const int handle   = fileno(m_file);
+        offset_t bytesRead = 0;
+        while (bytesRead < size_)
+        {
+            auto n = pread(handle, buffer + bytesRead, size_t(size_ - bytesRead), offset + bytesRead);
+            if (n > 0)
+            {
+                bytesRead += n;
+            }
+            else if (!(n < 0 && errno == EINTR))
+            {
+                // Error or end of file
+                break;
+            }
+        }
+        return bytesRead;
+#endif
+    }
+
     bool FileStream::absoluteSeek(offset_t offset)
     {
         if (m_file)
@@ -45,6 +45,15 @@ namespace HEIF
         @param [offset] Offset to seek iEOF*/
         bool absoluteSeek(offset_t offset) override;
 
+        /** Reads data from the given offset without modifying the current offset.
+        Uses pread() where available, otherwise reports positional reads as
+        unsupported.
+        @param [offset] Offset to read from
+        @param [buffer] The buffer to write the data into
+        @param [size]   The number of bytes to read from the stream
+        @returns The number of bytes read, or 0 on EOF. */
+        offset_t readAt(offset_t offset, char* buffer, offset_t size) override;
+
         /** Retrieve the current offset of the file.
         @returns The current offset of the fiEOF*/
         offset_t tell() override;
@@ -20,10 +20,24 @@
 #include "heifstreamlinux.hpp"
 #endif  // HEIF_USE_LINUX_FILESTREAM
 
+#ifdef HEIF_USE_MMAP_FILESTREAM
+#include "heifstreammmap.hpp"
+#endif  // HEIF_USE_MMAP_FILESTREAM
+
 namespace HEIF
 {
     StreamInterface* openFile(const char* filename)
     {
+#ifdef HEIF_USE_MMAP_FILESTREAM
+        // Prefer a memory mapping; fall back to buffered reads for empty files, pipes etc.
+        MmapStream* mapped = CUSTOM_NEW(MmapStream, (filename));
+        if (mapped->isOpen())
+        {
+            return mapped;
+        }
+        CUSTOM_DELETE(mapped, MmapStream);
+#endif  // HEIF_USE_MMAP_FILESTREAM
+
 #ifdef HEIF_USE_LINUX_FILESTREAM
         return CUSTOM_NEW(LinuxStream, (filename));
 #else
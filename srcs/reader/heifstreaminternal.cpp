@@ -13,6 +13,8 @@
 
 #include "heifstreaminternal.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 #include "customallocator.hpp"
@@ -26,18 +28,110 @@ namespace HEIF
     } while (0)
     //#define TRACE(x) x
 
-    InternalStream::InternalStream(StreamInterface* stream)
+    InternalStream::InternalStream(StreamInterface* stream, const std::uint32_t readAheadSize)
         : m_stream(stream)
         , m_error(false)
         , m_eof(false)
+        , m_buffer()
+        , m_bufferData(nullptr)
+        , m_bufferStart(0)
+        , m_bufferSize(0)
+        , m_position(0)
+        , m_streamPosition(0)
+        , m_readAheadSize(std::max<StreamInterface::offset_t>(readAheadSize, 1))
+        , m_directAccess(false)
     {
         m_error = !stream || !stream->absoluteSeek(0);
+        if (!m_error && stream->data() && stream->size() != StreamInterface::IndeterminateSize)
+        {
+            m_bufferData   = stream->data();
+            m_bufferSize   = stream->size();
+            m_directAccess = true;
+        }
+    }
+
+    StreamInterface::offset_t InternalStream::readBuffered(char* buffer, const StreamInterface::offset_t size_)
+    {
+        StreamInterface::offset_t done = 0;
+        while (done < size_)
+        {
+            const StreamInterface::offset_t buffered = m_bufferStart + m_bufferSize - m_position;
+            if (m_position >= m_bufferStart && buffered > 0)
+            {
+                const StreamInterface::offset_t count = std::min(buffered, size_ - done);
+                std::memcpy(buffer + done, m_bufferData + (m_position - m_bufferStart), static_cast<size_t>(count));
+                m_position += count;
+                done += count;
+            }
+            else if (m_directAccess)
+            {
+                break;
+            }
+            else if (size_ - done >= m_readAheadSize)
+            {
+                // Large reads go directly to the destination.
+                if (!seekStream(m_position))
+                {
+                    break;
+                }
+                const StreamInterface::offset_t got = m_stream->read(buffer + done, size_ - done);
+                if (got <= 0)
+                {
+                    break;
+                }
+                m_position += got;
+                m_streamPosition = m_position;
+                done += got;
+            }
+            else if (!fillBuffer())
+            {
+                break;
+            }
+        }
+        return done;
+    }
+
+    bool InternalStream::fillBuffer()
+    {
+        if (m_buffer.empty())
+        {
+            m_buffer.resize(static_cast<size_t>(m_readAheadSize));
+        }
+        m_bufferData  = m_buffer.data();
+        m_bufferStart = m_position;
+        m_bufferSize  = 0;
+        if (!seekStream(m_position))
+        {
+            return false;
+        }
+        const StreamInterface::offset_t got = m_stream->read(m_buffer.data(), m_readAheadSize);
+        if (got <= 0)
+        {
+            return false;
+        }
+        m_bufferSize     = got;
+        m_streamPosition = m_position + got;
+        return true;
+    }
+
+    bool InternalStream::seekStream(const StreamInterface::offset_t offset)
+    {
+        if (m_streamPosition != offset)
+        {
+            if (!m_stream->absoluteSeek(offset))
+            {
+                m_streamPosition = -1;
+                return false;
+            }
+            m_streamPosition = offset;
+        }
+        return true;
     }
 
     void InternalStream::read(char* buffer, StreamInterface::offset_t size_)
     {
-        TRACE(logInfo() << "Reading " << size_ << " at " << m_stream->tell() << " ");
-        StreamInterface::offset_t got = m_stream->read(buffer, size_);
+        TRACE(logInfo() << "Reading " << size_ << " at " << m_position << " ");
+        StreamInterface::offset_t got = readBuffered(buffer, size_);
         if (got < size_)
         {
             TRACE(logInfo() << "FAIL!" << std::endl);
@@ -50,11 +144,35 @@ namespace HEIF
         }
     }
 
+    bool InternalStream::readAt(StreamInterface::offset_t offset, char* buffer, StreamInterface::offset_t size_)
+    {
+        TRACE(logInfo() << "Reading " << size_ << " at " << offset << std::endl);
+        if (!m_stream)
+        {
+            return false;
+        }
+
+        StreamInterface::offset_t got = m_stream->readAt(offset, buffer, size_);
+        if (got < 0)
+        {
+            std::lock_guard<std::mutex> lock(m_readAtMutex);
+            const StreamInterface::offset_t position = m_stream->tell();
+            got = m_stream->absoluteSeek(offset) ? m_stream->read(buffer, size_) : 0;
+            m_stream->absoluteSeek(position);  // Keeps m_streamPosition valid
+        }
+        return got == size_;
+    }
+
     int InternalStream::get()
     {
+        if (m_position >= m_bufferStart && m_position < m_bufferStart + m_bufferSize)
+        {
+            return static_cast<unsigned char>(m_bufferData[m_position++ - m_bufferStart]);
+        }
+
         char ch;
-        TRACE(logInfo() << "Getting at " << m_stream->tell() << " ");
-        StreamInterface::offset_t got = m_stream->read(&ch, sizeof(ch));
+        TRACE(logInfo() << "Getting at " << m_position << " ");
+        StreamInterface::offset_t got = readBuffered(&ch, sizeof(ch));
         if (got)
         {
             TRACE(logInfo() << "OK!" << std::endl);
@@ -70,26 +188,26 @@ namespace HEIF
 
     bool InternalStream::peekEof()
     {
-        char buffer;
-        TRACE(logInfo() << "Peek EOF at " << m_stream->tell() << " ");
-        auto was = m_stream->tell();
-        if (m_stream->read(&buffer, sizeof(buffer)) == 0)
+        TRACE(logInfo() << "Peek EOF at " << m_position << " ");
+        if ((m_position >= m_bufferStart && m_position < m_bufferStart + m_bufferSize) ||
+            (!m_directAccess && fillBuffer()))
         {
-            TRACE(logInfo() << "EOF!" << std::endl);
-            return true;
+            TRACE(logInfo() << "No EOF!" << std::endl);
+            return false;
         }
         else
         {
-            TRACE(logInfo() << "No EOF!" << std::endl);
-            m_stream->absoluteSeek(was);
-            return false;
+            TRACE(logInfo() << "EOF!" << std::endl);
+            return true;
         }
     }
 
     void InternalStream::seek(StreamInterface::offset_t offset)
     {
-        TRACE(logInfo() << "Seeking to " << offset << " at " << m_stream->tell() << " ");
-        if (!m_stream->absoluteSeek(offset))
+        TRACE(logInfo() << "Seeking to " << offset << " at " << m_position << " ");
+        const bool buffered = offset >= m_bufferStart && offset <= m_bufferStart + m_bufferSize;
+        m_position          = offset;
+        if (!buffered && !seekStream(offset))
         {
             TRACE(logInfo() << "FAIL!" << std::endl);
             m_eof   = true;
@@ -103,7 +221,7 @@ namespace HEIF
 
     StreamInterface::offset_t InternalStream::tell()
     {
-        return m_stream->tell();
+        return m_position;
     }
 
     StreamInterface::offset_t InternalStream::size()
@@ -111,6 +229,11 @@ namespace HEIF
         return m_stream->size();
     }
 
+    const char* InternalStream::data() const
+    {
+        return m_stream ? m_stream->data() : nullptr;
+    }
+
     void InternalStream::clear()
     {
         m_eof   = false;
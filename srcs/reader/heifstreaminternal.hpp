@@ -14,15 +14,26 @@
 #ifndef HEIFSTREAMINTERNAL_HPP_
 #define HEIFSTREAMINTERNAL_HPP_
 
+#include <cstdint>
+#include <mutex>
+
 #include "customallocator.hpp"
 #include "heifstreaminterface.h"
 
 namespace HEIF
 {
+    /** Sequential reads, seeks and EOF checks are served from a read-ahead buffer, so parsing box headers byte by
+     *  byte issues a few large reads to the underlying StreamInterface. Streams giving direct access to their
+     *  contents with StreamInterface::data() are read from memory without a buffer. */
     class InternalStream
     {
     public:
-        InternalStream(StreamInterface* stream = nullptr);
+        static const std::uint32_t DEFAULT_READ_AHEAD_SIZE = 64 * 1024;
+
+        /** @param [in] stream        Stream to read from.
+        @param [in] readAheadSize Size of the read-ahead buffer in bytes. 0 reads only the bytes requested. Reads at
+                                  least this large bypass the buffer. */
+        InternalStream(StreamInterface* stream = nullptr, std::uint32_t readAheadSize = DEFAULT_READ_AHEAD_SIZE);
         ~InternalStream() = default;
 
         /** Returns the number of bytes read. A short read sets the EOF flag.
@@ -30,6 +41,16 @@ namespace HEIF
         @param [size]   The number of bytes to read from the stream */
         void read(char* buffer, StreamInterface::offset_t size);
 
+        /** Reads data from the given offset without affecting the current
+        position or the error and EOF flags. Safe to call concurrently from
+        several threads as long as no other method is called at the same time.
+        Streams without positional read support are accessed under a lock.
+        @param [offset] Offset to read from
+        @param [buffer] The buffer to write the data into
+        @param [size]   The number of bytes to read from the stream
+        @return Returns true if all requested bytes were read. */
+        bool readAt(StreamInterface::offset_t offset, char* buffer, StreamInterface::offset_t size);
+
         /** Reads one character from the stream.
         @return Returns the character read or undefined on error. */
         int get();
@@ -47,6 +68,9 @@ namespace HEIF
         /// @see StreamInterface::size
         StreamInterface::offset_t size();
 
+        /// @see StreamInterface::data
+        const char* data() const;
+
         /** Returns false if we can read at least one byte from the
         current position of the file.  In other words, returns true if
         we have reached the end of the file (but before have read
@@ -64,9 +88,30 @@ namespace HEIF
         void clear();
 
     private:
+        /** Copies up to size bytes from the current position, advancing it.
+        @return Returns the number of bytes read. */
+        StreamInterface::offset_t readBuffered(char* buffer, StreamInterface::offset_t size);
+
+        /** Refills the read-ahead buffer from the current position.
+        @return Returns false if no bytes could be read. */
+        bool fillBuffer();
+
+        /** Seeks the underlying stream, unless it is already at the offset. */
+        bool seekStream(StreamInterface::offset_t offset);
+
         StreamInterface* m_stream;
         bool m_error;
         bool m_eof;
+        std::mutex m_readAtMutex;  ///< Serializes readAt() fallback for streams without positional reads
+
+        Vector<char> m_buffer;                       ///< Read-ahead buffer, allocated on first use
+        const char* m_bufferData;                    ///< m_buffer or the contents of a directly accessible stream
+        StreamInterface::offset_t m_bufferStart;     ///< Stream offset of m_bufferData[0]
+        StreamInterface::offset_t m_bufferSize;      ///< Valid bytes at m_bufferData
+        StreamInterface::offset_t m_position;        ///< Current read position
+        StreamInterface::offset_t m_streamPosition;  ///< Position of m_stream, -1 if not known
+        StreamInterface::offset_t m_readAheadSize;   ///< Capacity of m_buffer
+        bool m_directAccess;                         ///< m_bufferData holds the whole stream
     };
 }  // namespace HEIF
 
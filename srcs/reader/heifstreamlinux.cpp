@@ -156,6 +156,34 @@ namespace HEIF
         }
     }
 
+    LinuxStream::offset_t LinuxStream::readAt(offset_t offset, char* buffer, offset_t size_)
+    {
+        if (m_handle < 0)
+        {
+            return 0;
+        }
+
+        offset_t bytesRead = 0;
+        while (bytesRead < size_)
+        {
+            auto n = pread64(m_handle, buffer + bytesRead, size_t(size_ - bytesRead), offset + bytesRead);
+            if (n > 0)
+            {
+                bytesRead += n;
+            }
+            else if (n < 0 && (errno == EAGAIN || errno == EINTR))
+            {
+                // try again
+            }
+            else
+            {
+                // Error or end of file
+                break;
+            }
+        }
+        return bytesRead;
+    }
+
     bool LinuxStream::absoluteSeek(offset_t offset)
     {
         if (m_handle >= 0)
@@ -0,0 +1,142 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2025 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "heifstreammmap.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace HEIF
+{
+    MmapStream::MmapStream()
+        : m_data(nullptr)
+        , m_curOffset(0)
+        , m_size(0)
+    {
+        // nothing
+    }
+
+    MmapStream::MmapStream(const char* filename)
+        : m_data(nullptr)
+        , m_curOffset(0)
+        , m_size(0)
+    {
+        int handle = open(filename, O_RDONLY);
+        if (handle >= 0)
+        {
+            struct stat status;
+            // A file larger than the address space (e.g. 4 GiB or more on 32-bit targets) is not mapped, the caller then
+            // falls back to a buffered stream.
+            if (fstat(handle, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0 &&
+                static_cast<std::uint64_t>(status.st_size) <= std::numeric_limits<size_t>::max())
+            {
+                const size_t length = static_cast<size_t>(status.st_size);
+                void* mapping       = mmap(nullptr, length, PROT_READ, MAP_SHARED, handle, 0);
+                if (mapping != MAP_FAILED)
+                {
+                    m_data = static_cast<const char*>(mapping);
+                    m_size = static_cast<offset_t>(length);
+                }
+            }
+            // The mapping stays valid after the descriptor has been closed.
+            close(handle);
+        }
+    }
+
+    MmapStream& MmapStream::operator=(MmapStream&& other) noexcept
+    {
+        unmap();
+
+        m_data       = other.m_data;
+        other.m_data = nullptr;
+
+        m_curOffset       = other.m_curOffset;
+        other.m_curOffset = 0;
+
+        m_size       = other.m_size;
+        other.m_size = 0;
+
+        return *this;
+    }
+
+    MmapStream::~MmapStream()
+    {
+        unmap();
+    }
+
+    void MmapStream::unmap()
+    {
+        if (m_data)
+        {
+            munmap(const_cast<char*>(m_data), static_cast<size_t>(m_size));
+            m_data = nullptr;
+        }
+    }
+
+    bool MmapStream::isOpen() const
+    {
+        return m_data != nullptr;
+    }
+
+    MmapStream::offset_t MmapStream::read(char* buffer, offset_t size_)
+    {
+        offset_t bytesRead = readAt(m_curOffset, buffer, size_);
+        m_curOffset += bytesRead;
+        return bytesRead;
+    }
+
+    MmapStream::offset_t MmapStream::readAt(offset_t offset, char* buffer, offset_t size_)
+    {
+        if (!m_data || offset < 0 || offset >= m_size || size_ <= 0)
+        {
+            return 0;
+        }
+
+        offset_t bytesRead = std::min(size_, m_size - offset);
+        std::memcpy(buffer, m_data + offset, static_cast<size_t>(bytesRead));
+        return bytesRead;
+    }
+
+    bool MmapStream::absoluteSeek(offset_t offset)
+    {
+        if (!m_data || offset < 0)
+        {
+            return false;
+        }
+        m_curOffset = offset;
+        return true;
+    }
+
+    MmapStream::offset_t MmapStream::tell()
+    {
+        return m_curOffset;
+    }
+
+    MmapStream::offset_t MmapStream::size()
+    {
+        return m_size;
+    }
+
+    const char* MmapStream::data()
+    {
+        return m_data;
+    }
+}  // namespace HEIF
@@ -0,0 +1,79 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2025 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#ifndef HEIFSTREAMMMAP_HPP_
+#define HEIFSTREAMMMAP_HPP_
+
+#include "customallocator.hpp"
+#include "heifstreaminterface.h"
+
+namespace HEIF
+{
+    /** Read-only stream backed by a memory mapping of the whole file. Reads are plain memory copies and
+     *  data() exposes the mapping so that callers can access file contents without copying at all. */
+    class MmapStream : public StreamInterface
+    {
+    public:
+        MmapStream();
+        MmapStream(const char* filename);
+
+        MmapStream(const MmapStream& other) = delete;
+        MmapStream& operator=(const MmapStream& other) = delete;
+        MmapStream& operator                           =(MmapStream&& other) noexcept;
+
+        ~MmapStream() override;
+
+        /** Returns the number of bytes read. The value of 0 indicates end
+        of file.
+        @param [buffer] The buffer to write the data into
+        @param [size]   The number of bytes to read from the stream
+        @returns The number of bytes read, or 0 on EOF. */
+        offset_t read(char* buffer, offset_t size) override;
+
+        /** Seeks to the given offset. Should the offset be erronous we'll
+        find it out by the next read that will signal EOF.
+        @param [offset] Offset to seek into */
+        bool absoluteSeek(offset_t offset) override;
+
+        /** Retrieve the current offset of the file.
+        @returns The current offset of the file. */
+        offset_t tell() override;
+
+        /** Retrieve the size of the current file.
+        @returns The current size of the file. */
+        offset_t size() override;
+
+        /** Reads data from the given offset without modifying the current offset.
+        @param [offset] Offset to read from
+        @param [buffer] The buffer to write the data into
+        @param [size]   The number of bytes to read from the stream
+        @returns The number of bytes read, or 0 on EOF. */
+        offset_t readAt(offset_t offset, char* buffer, offset_t size) override;
+
+        /** Retrieve the start of the mapping.
+        @returns Pointer to the first byte of the file, or nullptr if the file is not mapped. */
+        const char* data() override;
+
+        /** Was the file successfully opened and mapped? */
+        bool isOpen() const;
+
+    private:
+        const char* m_data;
+        offset_t m_curOffset;
+        offset_t m_size;
+
+        void unmap();
+    };
+}  // namespace HEIF
+
+#endif  // HEIFSTREAMMMAP_HPP_
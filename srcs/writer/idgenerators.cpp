@@ -11,72 +11,150 @@
  * written consent of Nokia.
  */
 
+#include <cstring>
+
 #include "idgenerators.hpp"
 
-namespace Context
+ContextId ContextIdGenerator::getValue()
+{
+    return mValue++;
+}
+
+void ContextIdGenerator::reset()
+{
+    mValue = INITIAL_VALUE;
+}
+
+TrackIdGenerator::TrackIdGenerator(ContextIdGenerator& contextIds)
+    : mContextIds(contextIds)
 {
-    static const int INITIAL_VALUE = 1000;
-    ContextId mValue               = INITIAL_VALUE;
+}
 
-    ContextId getValue()
+HEIF::TrackId TrackIdGenerator::createTrackId()
+{
+    if (mTrackIdValue < ContextIdGenerator::INITIAL_VALUE)
     {
-        return mValue++;
+        return mTrackIdValue++;
     }
-
-    void reset()
+    else
     {
-        mValue = INITIAL_VALUE;
+        mTrackIdValue = mContextIds.getValue();
+        return mTrackIdValue;
     }
-}  // namespace Context
+}
 
-namespace Track
+HEIF::AlternateGroupId TrackIdGenerator::createAlternateGroupId()
 {
-    static const int INITIAL_VALUE = 1;
-    uint32_t mTrackIdValue         = INITIAL_VALUE;
-    uint16_t mAlternateGroupValue  = INITIAL_VALUE;
+    return mAlternateGroupValue++;
+}
 
-    HEIF::TrackId createTrackId()
+void TrackIdGenerator::reset()
+{
+    mTrackIdValue        = INITIAL_VALUE;
+    mAlternateGroupValue = INITIAL_VALUE;
+}
+
+namespace ContentHash
+{
+    namespace
     {
-        if (mTrackIdValue < Context::INITIAL_VALUE)
+        const uint64_t PRIME1 = 0x9E3779B185EBCA87u;
+        const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Fu;
+        const uint64_t PRIME3 = 0x165667B19E3779F9u;
+        const uint64_t PRIME4 = 0x85EBCA77C2B2AE63u;
+        const uint64_t PRIME5 = 0x27D4EB2F165667C5u;
+
+        inline uint64_t rotateLeft(const uint64_t value, const unsigned int bits)
         {
-            return mTrackIdValue++;
+            return (value << bits) | (value >> (64 - bits));
         }
-        else
+
+        inline uint64_t read64(const uint8_t* data)
         {
-            mTrackIdValue = Context::getValue();
-            return mTrackIdValue;
+            uint64_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
         }
-    }
 
-    HEIF::AlternateGroupId createAlternateGroupId()
-    {
-        return mAlternateGroupValue++;
-    }
+        inline uint32_t read32(const uint8_t* data)
+        {
+            uint32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
 
-    void reset()
-    {
-        mTrackIdValue        = INITIAL_VALUE;
-        mAlternateGroupValue = INITIAL_VALUE;
-    }
-}  // namespace Track
+        inline uint64_t round(uint64_t accumulator, const uint64_t input)
+        {
+            accumulator += input * PRIME2;
+            return rotateLeft(accumulator, 31) * PRIME1;
+        }
 
-namespace FNVHash
-{
-    // Calculate FNV-1a hash for null-terminated C-string, http://isthe.com/chongo/tech/comp/fnv/
+        inline uint64_t mergeRound(const uint64_t hash, const uint64_t accumulator)
+        {
+            return (hash ^ round(0, accumulator)) * PRIME1 + PRIME4;
+        }
+    }  // anonymous namespace
+
+    // XXH64 algorithm, https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+    // Four independent accumulators consume 32 bytes per iteration, which keeps the multipliers of the CPU busy.
     uint64_t generate(const uint8_t* aData, uint64_t aSize)
     {
-        static uint64_t offset = 2166136261u;
-        static uint64_t prime  = 16777619u;
+        const uint8_t* data      = aData;
+        const uint8_t* const end = aData + aSize;
+        uint64_t hash;
+
+        if (aSize >= 32)
+        {
+            uint64_t accumulator1 = PRIME1 + PRIME2;
+            uint64_t accumulator2 = PRIME2;
+            uint64_t accumulator3 = 0;
+            uint64_t accumulator4 = 0 - PRIME1;
+
+            const uint8_t* const stripesEnd = end - 32;
+            do
+            {
+                accumulator1 = round(accumulator1, read64(data));
+                accumulator2 = round(accumulator2, read64(data + 8));
+                accumulator3 = round(accumulator3, read64(data + 16));
+                accumulator4 = round(accumulator4, read64(data + 24));
+                data += 32;
+            } while (data <= stripesEnd);
 
-        uint64_t hash  = offset;
-        uint64_t index = 0;
-        while (index < aSize)
+            hash = rotateLeft(accumulator1, 1) + rotateLeft(accumulator2, 7) + rotateLeft(accumulator3, 12) +
+                   rotateLeft(accumulator4, 18);
+            hash = mergeRound(hash, accumulator1);
+            hash = mergeRound(hash, accumulator2);
+            hash = mergeRound(hash, accumulator3);
+            hash = mergeRound(hash, accumulator4);
+        }
+        else
+        {
+            hash = PRIME5;
+        }
+
+        hash += aSize;
+        for (; data + 8 <= end; data += 8)
+        {
+            hash ^= round(0, read64(data));
+            hash = rotateLeft(hash, 27) * PRIME1 + PRIME4;
+        }
+        if (data + 4 <= end)
+        {
+            hash ^= static_cast<uint64_t>(read32(data)) * PRIME1;
+            hash = rotateLeft(hash, 23) * PRIME2 + PRIME3;
+            data += 4;
+        }
+        for (; data < end; ++data)
         {
-            hash ^= static_cast<uint64_t>(aData[index]);
-            hash *= prime;
-            index++;
+            hash ^= static_cast<uint64_t>(*data) * PRIME5;
+            hash = rotateLeft(hash, 11) * PRIME1;
         }
 
+        hash ^= hash >> 33;
+        hash *= PRIME2;
+        hash ^= hash >> 29;
+        hash *= PRIME3;
+        hash ^= hash >> 32;
         return hash;
     }
-}  // namespace FNVHash
+}  // namespace ContentHash
@@ -20,18 +20,37 @@
 #include "writerdatatypesinternal.hpp"
 
 typedef std::uint32_t ContextId;
-namespace Context
+
+/** @brief Generator of the context IDs of a single writer.
+ *  @details Media data, item, entity group and sequence IDs are all drawn from the same value space. Each WriterImpl
+ *           owns its generators, so independent writers can run in parallel threads without sharing state. */
+class ContextIdGenerator
 {
+public:
+    static const ContextId INITIAL_VALUE = 1000;
+
     /** @brief Generate a context ID.
      * @return A new context ID. It will be unique, unless reset() has been called. */
     ContextId getValue();
 
     /** Reset ContextId value space. */
     void reset();
-}  // namespace Context
 
-namespace Track
+private:
+    ContextId mValue = INITIAL_VALUE;
+};
+
+/** @brief Generator of the track and alternate group IDs of a single writer.
+ *  @details Track IDs below ContextIdGenerator::INITIAL_VALUE are allocated sequentially, after which they are drawn
+ *           from the context ID value space. */
+class TrackIdGenerator
 {
+public:
+    static const std::uint32_t INITIAL_VALUE = 1;
+
+    /** @param [in] contextIds Context ID generator of the same writer. */
+    explicit TrackIdGenerator(ContextIdGenerator& contextIds);
+
     /** @brief Generate a track ID.
      * @return A new track ID. It will be unique, unless reset() has been called. */
     HEIF::TrackId createTrackId();
@@ -40,12 +59,22 @@ namespace Track
      * @return A new alternate group ID. It will be unique, unless reset() has been called. */
     HEIF::AlternateGroupId createAlternateGroupId();
 
-    /** Reset ContextId value space. */
+    /** Reset track and alternate group ID value spaces. */
     void reset();
-}  // namespace Track
 
-namespace FNVHash
+private:
+    ContextIdGenerator& mContextIds;
+    std::uint32_t mTrackIdValue        = INITIAL_VALUE;
+    std::uint16_t mAlternateGroupValue = INITIAL_VALUE;
+};
+
+namespace ContentHash
 {
+    /** @brief Calculate a 64-bit hash of a block of data, for detecting identical media data.
+     *  @details The result depends on the byte order of the platform, so it must not be stored to files.
+     *  @param [in] aData Data to hash.
+     *  @param [in] aSize Size of the data in bytes.
+     *  @return Hash of the data. */
     std::uint64_t generate(const uint8_t* aData, uint64_t aSize);
 }
 
@@ -1,4 +1,5 @@
-#include <fstream>
+#include <algorithm>
+#include <cstring>
 
 #include "OutputStreamInterface.h"
 #include "customallocator.hpp"
@@ -7,51 +8,155 @@
 
 namespace HEIF
 {
+    MemoryOutputStream::MemoryOutputStream(const std::uint64_t initialCapacity)
+        : mBuffer(nullptr)
+        , mCapacity(0)
+        , mSize(0)
+        , mPosition(0)
+    {
+        reserve(initialCapacity);
+    }
+
+    MemoryOutputStream::~MemoryOutputStream()
+    {
+        freeBuffer();
+    }
+
     void MemoryOutputStream::write(const void* aBuf, uint64_t aCount)
     {
-        if (aCount == 0) return;
-        
-        const uint8_t* src = static_cast<const uint8_t*>(aBuf);
-        const size_t newPosition = mPosition + static_cast<size_t>(aCount);
-        
-        // 确保缓冲区足够大
-        if (newPosition > mBuffer.size()) {
-            mBuffer.resize(newPosition);
+        if (aCount == 0)
+        {
+            return;
         }
-        
+
+        // 确保缓冲区足够大
+        const std::uint64_t newPosition = mPosition + aCount;
+        grow(newPosition);
+
         // 复制数据
-        std::copy(src, src + aCount, mBuffer.begin() + mPosition);
+        std::memcpy(mBuffer + mPosition, aBuf, static_cast<size_t>(aCount));
         mPosition = newPosition;
+        mSize     = std::max(mSize, mPosition);
+    }
+
+    void MemoryOutputStream::writeBuffers(const Buffer* buffers, uint64_t count)
+    {
+        // Grow the buffer once for all of the data instead of once per buffer.
+        std::uint64_t newPosition = mPosition;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            newPosition += buffers[i].size;
+        }
+        grow(newPosition);
+
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            write(buffers[i].data, buffers[i].size);
+        }
     }
 
     void MemoryOutputStream::seekp(std::uint64_t aPos)
     {
-        if (aPos > mBuffer.size()) {
+        if (aPos > mSize)
+        {
             // 扩展缓冲区并用0填充空隙
-            mBuffer.resize(static_cast<size_t>(aPos), 0);
+            grow(aPos);
+            std::memset(mBuffer + mSize, 0, static_cast<size_t>(aPos - mSize));
+            mSize = aPos;
         }
-        mPosition = static_cast<size_t>(aPos);
+        mPosition = aPos;
     }
 
     std::uint64_t MemoryOutputStream::tellp()
     {
-        return static_cast<std::uint64_t>(mPosition);
-    };
+        return mPosition;
+    }
 
     void MemoryOutputStream::remove()
     {
-        mBuffer.clear();
+        freeBuffer();
+    }
+
+    void MemoryOutputStream::reserve(const std::uint64_t capacity)
+    {
+        if (capacity > mCapacity)
+        {
+            reallocate(capacity);
+        }
+    }
+
+    bool MemoryOutputStream::releaseBuffer(Array<std::uint8_t>& buffer)
+    {
+        CUSTOM_DELETE_ARRAY(buffer.elements, std::uint8_t);
+        buffer.elements = nullptr;
+        buffer.size     = 0;
+        if (mBuffer != nullptr)
+        {
+            // The Array destructor reads the element count from the header, not the allocated capacity.
+            *(reinterpret_cast<size_t*>(mBuffer) - 1) = static_cast<size_t>(mSize);
+            buffer.elements                           = mBuffer;
+            buffer.size                               = static_cast<size_t>(mSize);
+        }
+        mBuffer   = nullptr;
+        mCapacity = 0;
+        mSize     = 0;
         mPosition = 0;
-    };
+        return true;
+    }
+
+    const uint8_t* MemoryOutputStream::data()
+    {
+        return mBuffer;
+    }
+
+    std::uint64_t MemoryOutputStream::size()
+    {
+        return mSize;
+    }
+
+    void MemoryOutputStream::grow(const std::uint64_t minCapacity)
+    {
+        if (minCapacity > mCapacity)
+        {
+            reallocate(std::max(minCapacity, mCapacity + mCapacity / 2));
+        }
+    }
+
+    void MemoryOutputStream::reallocate(const std::uint64_t capacity)
+    {
+        // Same layout as CUSTOM_NEW_ARRAY(std::uint8_t, n), but without value-initializing the bytes.
+        auto* header = static_cast<size_t*>(customAllocate(sizeof(size_t) + static_cast<size_t>(capacity)));
+        *header      = static_cast<size_t>(capacity);
+        auto* buffer = reinterpret_cast<std::uint8_t*>(header + 1);
+        if (mBuffer != nullptr)
+        {
+            std::memcpy(buffer, mBuffer, static_cast<size_t>(mSize));
+            customDeallocate(reinterpret_cast<size_t*>(mBuffer) - 1);
+        }
+        mBuffer   = buffer;
+        mCapacity = capacity;
+    }
+
+    void MemoryOutputStream::freeBuffer()
+    {
+        if (mBuffer != nullptr)
+        {
+            customDeallocate(reinterpret_cast<size_t*>(mBuffer) - 1);
+        }
+        mBuffer   = nullptr;
+        mCapacity = 0;
+        mSize     = 0;
+        mPosition = 0;
+    }
 
     bool MemoryOutputStream::is_open()
     {
         return true;
     }
 
-    OutputStreamInterface* ConstructMemoryStream()
+    OutputStreamInterface* ConstructMemoryStream(const std::uint64_t initialCapacity)
     {
-        OutputStreamInterface* aFile = new MemoryOutputStream();
+        OutputStreamInterface* aFile = new MemoryOutputStream(initialCapacity);
         if (!static_cast<MemoryOutputStream*>(aFile)->is_open())
         {
             delete aFile;
@@ -60,4 +165,3 @@ namespace HEIF
         return aFile;
     }
 }  // namespace HEIF
- 
\ No newline at end of file
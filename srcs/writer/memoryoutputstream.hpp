@@ -1,45 +1,57 @@
 #ifndef MEMORYOUTPUTSTREAM_HPP
 #define MEMORYOUTPUTSTREAM_HPP
 
-#include <vector>
 #include "OutputStreamInterface.h"
 #include "customallocator.hpp"
+#include "heifcommondatatypes.h"
 
 namespace HEIF
 {
+    /** Output stream to a growing memory buffer. The buffer grows geometrically and is not zero-filled on growth.
+     *  It is allocated in the layout of Array<std::uint8_t>, so releaseBuffer() can hand it over without a copy. */
     class MemoryOutputStream : public OutputStreamInterface
     {
     public:
-        MemoryOutputStream(size_t initialCapacity = 0)
-            : mPosition(0)
-        {
-            mBuffer.reserve(initialCapacity);
-        }
+        MemoryOutputStream(std::uint64_t initialCapacity = 0);
 
-        ~MemoryOutputStream() override
-        {
-        }
+        ~MemoryOutputStream() override;
 
         bool is_open();
 
         void write(const void* buf, uint64_t count) override;
 
+        void writeBuffers(const Buffer* buffers, uint64_t count) override;
+
         void seekp(std::uint64_t aPos) override;
 
         std::uint64_t tellp() override;
 
         void remove() override;
 
+        void reserve(std::uint64_t capacity) override;
+
+        bool releaseBuffer(Array<std::uint8_t>& buffer) override;
+
         // 获取底层内存指针
-        const uint8_t* data() { return mBuffer.data(); }
+        const uint8_t* data() override;
 
-        std::uint64_t size() { return mBuffer.size(); }
+        std::uint64_t size() override;
 
     private:
-        std::vector<uint8_t> mBuffer; // 内存存储核心
-        size_t mPosition;             // 当前写入位置
+        /// Grow the buffer geometrically so that it holds at least minCapacity bytes.
+        void grow(std::uint64_t minCapacity);
+
+        /// Reallocate the buffer to the given capacity, keeping its content.
+        void reallocate(std::uint64_t capacity);
+
+        /// Free the buffer and reset the stream to empty.
+        void freeBuffer();
+
+        std::uint8_t* mBuffer;    ///< Elements of the buffer, preceded by the Array element count header
+        std::uint64_t mCapacity;  ///< Allocated size of the buffer in bytes
+        std::uint64_t mSize;      ///< Size of the written data in bytes
+        std::uint64_t mPosition;  // 当前写入位置
     };
- }  // namespace HEIF
- 
- #endif
- 
\ No newline at end of file
+}  // namespace HEIF
+
+#endif
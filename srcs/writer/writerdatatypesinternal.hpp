@@ -30,7 +30,8 @@ namespace HEIF
         MediaFormat mediaFormat;
         DecoderConfigId decoderConfigId;
         uint64_t offset;  ///< Data offset. When mdat is after ftyp this is fileoffset. When mdat is lcoated after moov
-                          ///< this is offset from mdat start.
+                          ///< this is offset from mdat start. In fragmented output this is offset from the first fed
+                          ///< media data byte.
         size_t size;
     };
 
@@ -82,6 +83,8 @@ namespace HEIF
             Set<MetadataItemId> metadataItemsIds;
         };
         Vector<Sample> samples;
+        uint32_t writtenSampleCount;  // Samples already written to movie fragments and removed from samples.
+        uint64_t writtenDuration;     // Decode time of the first sample after those written to movie fragments.
         Vector<DecoderConfigId> decoderConfigs;
         bool anyNonSyncSample;
         CodingConstraints codingConstraints;  // for image sequences.
@@ -13,6 +13,7 @@
 
 #include "writerimpl.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <limits>
@@ -20,6 +21,8 @@
 #include "buildinfo.hpp"
 #include "customallocator.hpp"
 #include "jpegparser.hpp"
+#include "moviefragmentbox.hpp"
+#include "segmentindexbox.hpp"
 
 using namespace std;
 
@@ -49,6 +52,25 @@ namespace HEIF
             const Vector<uint8_t>& data = input.getStorage();
             output->write(data.data(), static_cast<uint64_t>(data.size()));
         }
+
+        void appendBuffer(const BitStream& input, Vector<OutputStreamInterface::Buffer>& buffers)
+        {
+            const Vector<uint8_t>& data = input.getStorage();
+            buffers.push_back({data.data(), static_cast<uint64_t>(data.size())});
+        }
+
+        /// Append 'mdat' header and payload blocks, so that they can be written without concatenating them.
+        void appendMediaDataBuffers(const MediaDataBox& mediaDataBox, Vector<OutputStreamInterface::Buffer>& buffers)
+        {
+            const std::pair<const ISOBMFF::BitStream&, const List<Vector<uint8_t>>&>& data =
+                mediaDataBox.getSerializedData();
+            buffers.reserve(buffers.size() + data.second.size() + 1);
+            appendBuffer(data.first, buffers);
+            for (const auto& dataBlock : data.second)
+            {
+                buffers.push_back({dataBlock.data(), static_cast<uint64_t>(dataBlock.size())});
+            }
+        }
     }  // namespace
 
     HEIF_DLL_PUBLIC ErrorCode Writer::SetCustomAllocator(CustomAllocator* customAllocator)
@@ -83,6 +105,7 @@ namespace HEIF
         , mAllDecoderConfigs()
         , mMediaData()
         , mMediaDataHashes()
+        , mRetainedMediaData()
         , mImageSequences()
         , mImageCollection()
         , mEntityGroups()
@@ -98,6 +121,8 @@ namespace HEIF
         , mMetaBox()
         , mMovieBox()
         , mMediaDataBox()
+        , mContextIds()
+        , mTrackIds(mContextIds)
     {
         mFile = nullptr;
         mMemory = nullptr;
@@ -112,12 +137,13 @@ namespace HEIF
 
     void WriterImpl::clear()
     {
-        Context::reset();
-        Track::reset();
+        mContextIds.reset();
+        mTrackIds.reset();
 
         mAllDecoderConfigs.clear();
         mMediaData.clear();
         mMediaDataHashes.clear();
+        mRetainedMediaData.clear();
         mImageSequences.clear();
         mImageCollection = {};
         mEntityGroups.clear();
@@ -140,8 +166,20 @@ namespace HEIF
         mInitialMdat    = false;
         mPrimaryItemSet = false;
 
+        mFragmented             = false;
+        mMoovWritten            = false;
+        mFragmentSampleCount    = 0;
+        mFragmentDuration       = 0;
+        mFragmentSequenceNumber = 0;
+        mFragmentedDataSize     = 0;
+        mPendingDataOffset      = 0;
+        mFragmentMdatBases.clear();
+
         mPredRrefPropertyId = 0;
 
+        mDeduplicateMediaData = true;
+        mCompareMediaData     = false;
+
         if (mState == State::WRITING)
         {
             mFile->remove();
@@ -164,10 +202,14 @@ namespace HEIF
         }
 
         clear();
-        Context::reset();
-        Track::reset();
+        mContextIds.reset();
+        mTrackIds.reset();
+
+        mFragmentSampleCount = outputConfig.fragmentSampleCount;
+        mFragmentDuration    = outputConfig.fragmentDuration;
+        mFragmented          = (mFragmentSampleCount != 0) || (mFragmentDuration != 0);
 
-        if (outputConfig.progressiveFile)
+        if (outputConfig.progressiveFile && !mFragmented)
         {
             mInitialMdat = false;           // 确定mdat box写在meta和moov box之后
         }
@@ -177,10 +219,13 @@ namespace HEIF
             {
                 return ErrorCode::BRANDS_NOT_SET;
             }
-            mInitialMdat = true;
+            // Fragmented output writes 'ftyp' here too, but 'mdat' boxes only along with movie fragments.
+            mInitialMdat = !mFragmented;
         }
 
         mWriteItemCreationTimes = outputConfig.itemCreationTimes;   // 是否记录图像项的创建时间
+        mDeduplicateMediaData   = outputConfig.deduplicateMediaData;
+        mCompareMediaData       = outputConfig.compareDeduplicatedMediaData;
 
         mFile = nullptr;
         mMemory = nullptr;
@@ -225,7 +270,7 @@ namespace HEIF
             mFileTypeBox.addCompatibleBrand(outputConfig.majorBrand.value);
         }
 
-        if (mInitialMdat)   // 非渐进式文件写入模式，ftyp在initialize()时写入，媒体数据mdat实时追加，元数据meta/moov在文件尾写入
+        if (mInitialMdat || mFragmented)   // 非渐进式文件写入模式，ftyp在initialize()时写入，媒体数据mdat实时追加，元数据meta/moov在文件尾写入
         {
             BitStream output;
             mFileTypeBox.writeBox(output);  // 写入ftyp box
@@ -235,6 +280,12 @@ namespace HEIF
             }
             OutputStreamInterface* pOutputStream = (mFile != nullptr ? mFile : mMemory);
             writeBitstream(output, pOutputStream);  // 将ftyp盒子数据写入文件
+        }
+
+        if (mInitialMdat)
+        {
+            BitStream output;
+            OutputStreamInterface* pOutputStream = (mFile != nullptr ? mFile : mMemory);
 
             // Write Media Data Box 'mdat' header. We can not know input data size, so use 64-bit large size field for
             // the box.
@@ -258,7 +309,7 @@ namespace HEIF
         }
 
         /// @todo Check parameter set integrity?
-        decoderConfigId                     = Context::getValue();
+        decoderConfigId                     = mContextIds.getValue();
         mAllDecoderConfigs[decoderConfigId] = config;
         return ErrorCode::OK;
     }
@@ -373,17 +424,46 @@ namespace HEIF
         return ErrorCode::OK;
     }
 
+    bool WriterImpl::findDuplicateMediaData(const Data& aData, const uint64_t aHash, MediaDataId& aMediaDataId) const
+    {
+        const auto hashEntry = mMediaDataHashes.find(aHash);
+        if (hashEntry == mMediaDataHashes.end())
+        {
+            return false;
+        }
+
+        const MediaData& mediaData = mMediaData.at(hashEntry->second);
+        if (mediaData.size != aData.size || mediaData.mediaFormat != aData.mediaFormat ||
+            mediaData.decoderConfigId != aData.decoderConfigId)
+        {
+            return false;
+        }
+
+        if (mCompareMediaData)
+        {
+            // Data already written to the output can not be compared, so it is not reused.
+            const auto retained = mRetainedMediaData.find(mediaData.id);
+            if (retained == mRetainedMediaData.end() || std::memcmp(retained->second, aData.data, aData.size) != 0)
+            {
+                return false;
+            }
+        }
+
+        aMediaDataId = mediaData.id;
+        return true;
+    }
+
     ErrorCode WriterImpl::storeFedMediaData(const Data& aData, MediaDataId& aMediaDataId)
     {
-        uint64_t hash = FNVHash::generate(aData.data, aData.size);
-        if (mMediaDataHashes.count(hash))
+        const uint64_t hash = mDeduplicateMediaData ? ContentHash::generate(aData.data, aData.size) : 0;
+        if (mDeduplicateMediaData && findDuplicateMediaData(aData, hash, aMediaDataId))
         {
-            aMediaDataId = mMediaDataHashes.at(hash);
+            return ErrorCode::OK;
         }
         else
         {
             MediaData mediaData       = {};
-            mediaData.id              = Context::getValue();
+            mediaData.id              = mContextIds.getValue();
             mediaData.mediaFormat     = aData.mediaFormat;
             mediaData.decoderConfigId = aData.decoderConfigId;
             mediaData.size            = aData.size;
@@ -434,6 +514,13 @@ namespace HEIF
                 mediaData.offset = pOutputStream->tellp();
                 pOutputStream->write(aData.data, static_cast<uint64_t>(aData.size));
             }
+            else if (mFragmented)
+            {
+                // Kept until the next fragment; its file offset is known once the 'mdat' containing it is written.
+                mediaData.offset = mFragmentedDataSize;
+                mMediaDataBox.addData(aData.data, aData.size);
+                mFragmentedDataSize += aData.size;
+            }
             else
             {
                 mediaData.offset = mMediaDataBox.addData(aData.data, aData.size);
@@ -445,7 +532,22 @@ namespace HEIF
 
             mMediaData[mediaData.id] = mediaData;
             aMediaDataId             = mediaData.id;
-            mMediaDataHashes[hash]   = mediaData.id;
+            if (mDeduplicateMediaData)
+            {
+                // On a hash collision the earlier data stays in the index, the new data is just not deduplicated.
+                // Unless the earlier data has already left memory: it can not be compared anymore, so later duplicates
+                // are compared with the new data instead.
+                const auto hashEntry = mMediaDataHashes.insert(std::make_pair(hash, mediaData.id));
+                if (!hashEntry.second && mCompareMediaData &&
+                    mRetainedMediaData.find(hashEntry.first->second) == mRetainedMediaData.end())
+                {
+                    hashEntry.first->second = mediaData.id;
+                }
+                if (mCompareMediaData && !mInitialMdat)
+                {
+                    mRetainedMediaData[mediaData.id] = mMediaDataBox.getSerializedData().second.back().data();
+                }
+            }
         }
         return ErrorCode::OK;
     }
@@ -459,7 +561,7 @@ namespace HEIF
 
         EntityGroup group;
         group.type = type;
-        group.id   = Context::getValue();
+        group.id   = mContextIds.getValue();
 
         mEntityGroups[group.id] = group;
 
@@ -520,7 +622,7 @@ namespace HEIF
 
         TrackGroup group;
         group.type = type;
-        group.id   = Context::getValue();
+        group.id   = mContextIds.getValue();
 
         mTrackGroups[group.id] = group;
 
@@ -557,7 +659,7 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
-        if (mInitialMdat)
+        if (mInitialMdat || mFragmented)
         {
             return ErrorCode::FTYP_ALREADY_WRITTEN;
         }
@@ -574,7 +676,7 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
-        if (mInitialMdat)
+        if (mInitialMdat || mFragmented)
         {
             return ErrorCode::FTYP_ALREADY_WRITTEN;
         }
@@ -592,7 +694,7 @@ namespace HEIF
 
         // Check if file type box has already been written. If so, return error in case a new type combination box would
         // be needed.
-        if (mInitialMdat)
+        if (mInitialMdat || mFragmented)
         {
             Vector<FourCCInt> brandVector;
             for (const auto& brand : compatibleBrandCombination)
@@ -628,7 +730,30 @@ namespace HEIF
         }
 
         BitStream output;
-        if (mInitialMdat)
+        if (mFragmented)
+        {
+            // Samples added after the previous fragment, and media data not written with any fragment (e.g. data of
+            // image items), go to the end of the file before 'meta'.
+            ErrorCode error = writeMovieFragment();
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+            if (mFragmentedDataSize > mPendingDataOffset)
+            {
+                writeFragmentMdatBox();
+            }
+            error = finalizeMetaBox();
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+            mMetaBox.setItemFileOffsetBases(mFragmentMdatBases);
+            OutputStreamInterface* pOutputStream = (mFile != nullptr ? mFile : mMemory);
+            mMetaBox.writeBox(output);
+            writeBitstream(output, pOutputStream);
+        }
+        else if (mInitialMdat)
         {
             finalizeMdatBox();
             ErrorCode error = finalizeMetaBox();
@@ -642,14 +767,16 @@ namespace HEIF
                 return error;
             }
             OutputStreamInterface* pOutputStream = (mFile != nullptr ? mFile : mMemory);
+            BitStream moovOutput;
             mMetaBox.writeBox(output);
-            writeBitstream(output, pOutputStream);
-            output.clear();
             if (mMovieBox.getTrackBoxes().size() > 0)
             {
-                mMovieBox.writeBox(output);
-                writeBitstream(output, pOutputStream);
+                mMovieBox.writeBox(moovOutput);
             }
+            Vector<OutputStreamInterface::Buffer> buffers;
+            appendBuffer(output, buffers);
+            appendBuffer(moovOutput, buffers);
+            pOutputStream->writeBuffers(buffers.data(), buffers.size());
         }
         else
         {
@@ -676,43 +803,36 @@ namespace HEIF
                 mExtendedTypeBox.writeBox(output);
             }
             OutputStreamInterface* pOutputStream = (mFile != nullptr ? mFile : mMemory);
-            writeBitstream(output, pOutputStream);
             mdatOffset = output.getSize();
-            output.clear();
-            // Calculate meta box size.
-            mMetaBox.writeBox(output);
-            mdatOffset += output.getSize();
-            output.clear();
-            // Calculate optional moov box size.
-            if (mMovieBox.getTrackBoxes().size() > 0)
-            {
-                mMovieBox.writeBox(output);
-                mdatOffset += output.getSize();
-                output.clear();
-            }
-            mMetaBox.setItemFileOffsetBase(mdatOffset);
-            updateMoovBox(mdatOffset);
 
-            // Serialize meta box again, now with correct mdat offset, and write it.
-            mMetaBox.writeBox(output);
-            writeBitstream(output, pOutputStream);
-            output.clear();
-            // Write optional moov box.
+            // Serialize meta and optional moov boxes once. Their sizes do not depend on the offset values, so the
+            // offsets to mdat data are patched in place after the sizes are known.
+            BitStream metaOutput;
+            mMetaBox.writeBox(metaOutput);
+            mdatOffset += metaOutput.getSize();
+            BitStream moovOutput;
             if (mMovieBox.getTrackBoxes().size() > 0)
             {
-                mMovieBox.writeBox(output);
-                writeBitstream(output, pOutputStream);
-                output.clear();
+                mMovieBox.writeBox(moovOutput);
+                mdatOffset += moovOutput.getSize();
             }
-            // Finally write mdat.
-
-            const std::pair<const ISOBMFF::BitStream&, const List<Vector<uint8_t>>&>& data =
-                mMediaDataBox.getSerializedData();
-            pOutputStream->write(data.first.getStorage().data(), data.first.getStorage().size());
-            for (const auto& dataBlock : data.second)
+            mMetaBox.setItemFileOffsetBase(mdatOffset);
+            mMetaBox.updateSerializedItemFileOffsets(metaOutput);
+            updateMoovBox(mdatOffset, moovOutput);
+
+            // Write the file type, meta, optional moov and mdat boxes in one go, without concatenating them.
+            Vector<OutputStreamInterface::Buffer> buffers;
+            appendBuffer(output, buffers);
+            appendBuffer(metaOutput, buffers);
+            appendBuffer(moovOutput, buffers);
+            appendMediaDataBuffers(mMediaDataBox, buffers);
+            uint64_t fileSize = pOutputStream->tellp();
+            for (const auto& buffer : buffers)
             {
-                pOutputStream->write(dataBlock.data(), static_cast<uint64_t>(dataBlock.size()));
+                fileSize += buffer.size;
             }
+            pOutputStream->reserve(fileSize);
+            pOutputStream->writeBuffers(buffers.data(), buffers.size());
         }
         if (mOwnsOutputHandle)
         {
@@ -746,4 +866,268 @@ namespace HEIF
         pOutputStream->seekp(position);
     }
 
+    bool WriterImpl::isFragmentDue() const
+    {
+        std::uint64_t pendingSamples = 0;
+        for (const auto& imageSequence : mImageSequences)
+        {
+            const ImageSequence& sequence = imageSequence.second;
+            if (sequence.samples.empty())
+            {
+                continue;
+            }
+            pendingSamples += sequence.samples.size();
+
+            const uint64_t pendingDuration =
+                sequence.samples.back().dts + sequence.samples.back().sampleDuration - sequence.samples.front().dts;
+            if (mFragmentDuration &&
+                pendingDuration * 1000 >= static_cast<uint64_t>(mFragmentDuration) * sequence.timeBase.den)
+            {
+                return true;
+            }
+        }
+        return mFragmentSampleCount && pendingSamples >= mFragmentSampleCount;
+    }
+
+    uint64_t WriterImpl::getFragmentedFileOffset(const uint64_t dataOffset) const
+    {
+        auto mdat = mFragmentMdatBases.upper_bound(dataOffset);
+        assert(mdat != mFragmentMdatBases.begin());
+        return dataOffset + (--mdat)->second;
+    }
+
+    void WriterImpl::writeFragmentMdatBox()
+    {
+        OutputStreamInterface* pOutputStream = (mFile != nullptr ? mFile : mMemory);
+        const std::pair<const ISOBMFF::BitStream&, const List<Vector<uint8_t>>&>& data =
+            mMediaDataBox.getSerializedData();
+
+        const uint64_t dataStart               = pOutputStream->tellp() + data.first.getSize();
+        mFragmentMdatBases[mPendingDataOffset] = dataStart - mPendingDataOffset;
+        mPendingDataOffset                     = mFragmentedDataSize;
+
+        Vector<OutputStreamInterface::Buffer> buffers;
+        appendMediaDataBuffers(mMediaDataBox, buffers);
+        pOutputStream->writeBuffers(buffers.data(), buffers.size());
+        mMediaDataBox = {};
+        mRetainedMediaData.clear();
+    }
+
+    ErrorCode WriterImpl::writeMovieFragment()
+    {
+        OutputStreamInterface* pOutputStream = (mFile != nullptr ? mFile : mMemory);
+        BitStream output;
+
+        if (!mMoovWritten && !mImageSequences.empty())
+        {
+            ErrorCode error = generateMoovBox();
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+            mMovieBox.writeBox(output);
+            writeBitstream(output, pOutputStream);
+            output.clear();
+            mMoovWritten = true;
+        }
+
+        struct TrackRun
+        {
+            TrackRunBox* box;
+            uint64_t dataOffset;  ///< Fed data offset of the first sample of the run.
+            uint64_t baseOffset;  ///< File offset the run data offset is relative to, unless the base is 'moof'.
+            bool baseIsMoof;
+        };
+        Vector<TrackRun> trackRuns;
+
+        Vector<MOVIEFRAGMENTS::SampleDefaults> sampleDefaults;  // Used only when parsing.
+        MovieFragmentBox moof(sampleDefaults);
+
+        // The first track with samples is the reference stream of the segment index.
+        const ImageSequence* indexSequence = nullptr;
+        SegmentIndexBox::Reference reference{};
+        uint64_t earliestPresentationTime = std::numeric_limits<uint64_t>::max();
+
+        for (auto& imageSequence : mImageSequences)
+        {
+            const ImageSequence& sequence = imageSequence.second;
+            if (sequence.samples.empty())
+            {
+                continue;
+            }
+
+            if (indexSequence == nullptr)
+            {
+                indexSequence           = &sequence;
+                reference.startsWithSAP = sequence.samples.front().isSyncSample;
+                reference.sapType       = reference.startsWithSAP ? 1 : 0;
+                for (const auto& sample : sequence.samples)
+                {
+                    reference.subsegmentDuration += sample.sampleDuration;
+                    const int64_t compositionTime = static_cast<int64_t>(sample.dts) + sample.compositionOffset;
+                    if (!sample.isHidden && compositionTime >= 0 &&
+                        static_cast<uint64_t>(compositionTime) < earliestPresentationTime)
+                    {
+                        earliestPresentationTime = static_cast<uint64_t>(compositionTime);
+                    }
+                }
+            }
+
+            // Each track fragment holds consecutive samples with the same sample description.
+            auto sample = sequence.samples.cbegin();
+            while (sample != sequence.samples.cend())
+            {
+                const uint32_t sampleDescriptionIndex = sample->decoderConfigIndex;
+                const auto fragmentEnd =
+                    std::find_if(sample, sequence.samples.cend(), [&](const ImageSequence::Sample& other) {
+                        return other.decoderConfigIndex != sampleDescriptionIndex;
+                    });
+
+                // Data offsets are relative to 'moof' when all sample data goes to the 'mdat' of this fragment.
+                // Otherwise, e.g. for data shared with earlier samples, relative to the first sample data in the file.
+                uint64_t baseOffset       = std::numeric_limits<uint64_t>::max();
+                bool anyNegativeOffset    = false;
+                bool anyCompositionOffset = false;
+                for (auto it = sample; it != fragmentEnd; ++it)
+                {
+                    const uint64_t dataOffset = mMediaData.at(it->mediaDataId).offset;
+                    if (dataOffset < mPendingDataOffset)
+                    {
+                        baseOffset = std::min(baseOffset, getFragmentedFileOffset(dataOffset));
+                    }
+                    if ((it->compositionOffset < std::numeric_limits<std::int32_t>::min()) ||
+                        (it->compositionOffset > std::numeric_limits<std::int32_t>::max()))
+                    {
+                        return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                    }
+                    anyNegativeOffset    = anyNegativeOffset || it->isHidden || it->compositionOffset < 0;
+                    anyCompositionOffset = anyCompositionOffset || it->isHidden || it->compositionOffset != 0;
+                }
+                const bool baseIsMoof = baseOffset == std::numeric_limits<uint64_t>::max();
+
+                UniquePtr<TrackFragmentBox> traf(CUSTOM_NEW(TrackFragmentBox, (sampleDefaults)));
+                TrackFragmentHeaderBox& tfhd = traf->getTrackFragmentHeaderBox();
+                tfhd.setFlags(TrackFragmentHeaderBox::SampleDescriptionIndexPresent |
+                              (baseIsMoof ? TrackFragmentHeaderBox::DefaultBaseIsMoof
+                                          : TrackFragmentHeaderBox::BaseDataOffsetPresent));
+                tfhd.setTrackId(sequence.trackId.get());
+                tfhd.setSampleDescriptionIndex(sampleDescriptionIndex);
+                if (!baseIsMoof)
+                {
+                    tfhd.setBaseDataOffset(baseOffset);
+                }
+
+                UniquePtr<TrackFragmentBaseMediaDecodeTimeBox> tfdt(
+                    CUSTOM_NEW(TrackFragmentBaseMediaDecodeTimeBox, ()));
+                tfdt->setVersion(1);
+                tfdt->setBaseMediaDecodeTime(sample->dts);
+                traf->setTrackFragmentDecodeTimeBox(std::move(tfdt));
+
+                const std::uint32_t runFlags =
+                    TrackRunBox::SampleDurationPresent | TrackRunBox::SampleSizePresent |
+                    TrackRunBox::SampleFlagsPresent |
+                    (anyCompositionOffset ? TrackRunBox::SampleCompositionTimeOffsetsPresent : 0);
+                TrackRunBox* trun       = nullptr;
+                uint64_t nextDataOffset = 0;
+                for (; sample != fragmentEnd; ++sample)
+                {
+                    const MediaData& sampleData = mMediaData.at(sample->mediaDataId);
+
+                    // A new run starts where sample data does not follow the previous sample data in the file.
+                    if (trun == nullptr || sampleData.offset != nextDataOffset ||
+                        sampleData.offset == mPendingDataOffset || mFragmentMdatBases.count(sampleData.offset))
+                    {
+                        UniquePtr<TrackRunBox> run(
+                            CUSTOM_NEW(TrackRunBox, (static_cast<uint8_t>(anyNegativeOffset ? 1 : 0), runFlags)));
+                        trun = run.get();
+                        trackRuns.push_back({trun, sampleData.offset, baseOffset, baseIsMoof});
+                        traf->addTrackRunBox(std::move(run));
+                    }
+                    nextDataOffset = sampleData.offset + sampleData.size;
+
+                    TrackRunBox::SampleDetails details{};
+                    MOVIEFRAGMENTS::SampleFlagsType& flags = details.version1.sampleFlags.flags;
+                    details.version1.sampleDuration        = sample->sampleDuration;
+                    details.version1.sampleSize            = static_cast<uint32_t>(sampleData.size);
+                    flags.sample_depends_on                = sample->isSyncSample ? 2 : 1;
+                    flags.sample_is_non_sync_sample        = sample->isSyncSample ? 0 : 1;
+                    details.version1.sampleCompositionTimeOffset =
+                        sample->isHidden ? std::numeric_limits<std::int32_t>::min()
+                                         : static_cast<int32_t>(sample->compositionOffset);
+                    trun->addSampleDetails(details);
+                    trun->setSampleCount(trun->getSampleCount() + 1);
+                }
+
+                moof.addTrackFragmentBox(std::move(traf));
+            }
+        }
+
+        if (indexSequence == nullptr)
+        {
+            return ErrorCode::OK;  // No pending samples.
+        }
+        moof.getMovieFragmentHeaderBox().setSequenceNumber(++mFragmentSequenceNumber);
+
+        // Sizes do not depend on the data offsets, so serialize once to get them.
+        for (auto& trackRun : trackRuns)
+        {
+            trackRun.box->setDataOffset(0);
+        }
+        moof.writeBox(output);
+        const uint64_t moofSize = output.getSize();
+        output.clear();
+        const uint64_t pendingDataSize = mFragmentedDataSize - mPendingDataOffset;
+        const uint64_t mdatHeaderSize  = mMediaDataBox.getSerializedData().first.getSize();
+        const uint64_t mdatSize        = pendingDataSize ? mdatHeaderSize + pendingDataSize : 0;
+
+        // A fragment too large for the 31-bit referenced size is written without index.
+        if (moofSize + mdatSize <= 0x7fffffff)
+        {
+            SegmentIndexBox sidx(1);
+            sidx.setReferenceId(indexSequence->trackId.get());
+            sidx.setTimescale(static_cast<uint32_t>(indexSequence->timeBase.den));
+            sidx.setEarliestPresentationTime(earliestPresentationTime == std::numeric_limits<uint64_t>::max()
+                                                 ? indexSequence->samples.front().dts
+                                                 : earliestPresentationTime);
+            sidx.setFirstOffset(0);
+            reference.referencedSize = static_cast<uint32_t>(moofSize + mdatSize);
+            sidx.addReference(reference);
+            sidx.writeBox(output);
+        }
+
+        const uint64_t moofOffset = pOutputStream->tellp() + output.getSize();
+        const uint64_t dataStart  = moofOffset + moofSize + mdatHeaderSize;
+        for (const auto& trackRun : trackRuns)
+        {
+            const uint64_t fileOffset = trackRun.dataOffset >= mPendingDataOffset
+                                            ? dataStart + (trackRun.dataOffset - mPendingDataOffset)
+                                            : getFragmentedFileOffset(trackRun.dataOffset);
+            const uint64_t runOffset = fileOffset - (trackRun.baseIsMoof ? moofOffset : trackRun.baseOffset);
+            if (runOffset > static_cast<uint64_t>(std::numeric_limits<std::int32_t>::max()))
+            {
+                return ErrorCode::INVALID_MEDIADATA_ID;  // Sample data too far apart for one track fragment.
+            }
+            trackRun.box->setDataOffset(static_cast<int32_t>(runOffset));
+        }
+        moof.writeBox(output);
+        writeBitstream(output, pOutputStream);
+        if (pendingDataSize)
+        {
+            writeFragmentMdatBox();
+        }
+
+        for (auto& imageSequence : mImageSequences)
+        {
+            ImageSequence& sequence = imageSequence.second;
+            if (!sequence.samples.empty())
+            {
+                sequence.writtenSampleCount += static_cast<uint32_t>(sequence.samples.size());
+                sequence.writtenDuration = sequence.samples.back().dts + sequence.samples.back().sampleDuration;
+                sequence.samples.clear();
+            }
+        }
+
+        return ErrorCode::OK;
+    }
+
 }  // namespace HEIF
@@ -136,10 +136,18 @@ namespace HEIF
     private:
         ErrorCode isValidSequenceImage(const SequenceId& sequenceId, const SequenceImageId& sequenceImageId) const;
 
-        void finalizeMdatBox();                        // Set media data box size.
-        ErrorCode generateMoovBox();                   // Fill movie box from intermediate HeifWriterImpl structures.
-        ErrorCode updateMoovBox(uint64_t mdatOffset);  // Update moov box internal offset values to mdat data
-        ErrorCode finalizeMetaBox();                   // Fill metabox from intermediate HeifWriterImpl structures.
+        void finalizeMdatBox();       // Set media data box size.
+        ErrorCode generateMoovBox();  // Fill movie box from intermediate HeifWriterImpl structures.
+        ErrorCode finalizeMetaBox();  // Fill metabox from intermediate HeifWriterImpl structures.
+
+        /// Update moov box internal offset values to mdat data, also in moovOutput where moov box was serialized.
+        ErrorCode updateMoovBox(uint64_t mdatOffset, ISOBMFF::BitStream& moovOutput);
+
+        // movie fragment output helpers
+        bool isFragmentDue() const;       // True if pending samples reach the fragment sample count or duration.
+        ErrorCode writeMovieFragment();   // Write 'moov' if not yet written, and pending samples as a movie fragment.
+        void writeFragmentMdatBox();      // Write media data fed after the previous fragment as an 'mdat' box.
+        uint64_t getFragmentedFileOffset(uint64_t dataOffset) const;  // File offset of written fed media data.
 
         // writermoovimpl defines for moov writer helpers
         void writeMoovHiddenSamples(ImageSequence& sequence);
@@ -148,10 +156,12 @@ namespace HEIF
         void writeRefSampleList(ImageSequence& sequence);
         void writeMetadataItemGroups(ImageSequence& sequence);
         void writeTrackGroups(ImageSequence& imageSequence);
+        ErrorCode writeMoovSampleDescriptions(ImageSequence& sequence);
 
         // helpers for handling fed mediaData
         ErrorCode validateFedMediaData(const Data& aData);
         ErrorCode storeFedMediaData(const Data& aData, MediaDataId& aMediaDataId);
+        bool findDuplicateMediaData(const Data& aData, std::uint64_t aHash, MediaDataId& aMediaDataId) const;
 
         /**
          * Creates new metadataitem & id for given mediaDataId
@@ -257,7 +267,9 @@ namespace HEIF
 
         Map<DecoderConfigId, Array<DecoderSpecificInfo>> mAllDecoderConfigs;
         Map<MediaDataId, MediaData> mMediaData;
-        Map<std::uint64_t, MediaDataId> mMediaDataHashes;
+        Map<std::uint64_t, MediaDataId> mMediaDataHashes;  ///< Content hashes of fed media data.
+        Map<MediaDataId, const std::uint8_t*>
+            mRetainedMediaData;  ///< Fed media data still held in mMediaDataBox, for comparing duplicate candidates.
 
         Map<SequenceId, ImageSequence> mImageSequences;
         ImageCollection mImageCollection;
@@ -280,6 +292,9 @@ namespace HEIF
         MovieBox mMovieBox;
         MediaDataBox mMediaDataBox;
 
+        ContextIdGenerator mContextIds;  ///< Media data, item, entity group and sequence IDs of this writer.
+        TrackIdGenerator mTrackIds;      ///< Track and alternate group IDs of this writer.
+
         OutputStreamInterface* mFile;   // 文件流
         OutputStreamInterface* mMemory; // 内存流
 
@@ -291,10 +306,24 @@ namespace HEIF
                                     ///< after meta and moov boxes.
         bool mPrimaryItemSet = false;  ///< True after a primary item has been set.
 
+        bool mFragmented  = false;  ///< True if samples are written as movie fragments while they are added.
+        bool mMoovWritten = false;  ///< True after 'moov' of fragmented output has been written.
+        std::uint32_t mFragmentSampleCount    = 0;  ///< Pending samples that start a new fragment, 0 if not limited.
+        std::uint32_t mFragmentDuration       = 0;  ///< Pending track duration in milliseconds that starts a new
+                                                    ///< fragment, 0 if not limited.
+        std::uint32_t mFragmentSequenceNumber = 0;  ///< Sequence number of the last written 'moof'.
+        std::uint64_t mFragmentedDataSize     = 0;  ///< Bytes of media data fed in fragmented output.
+        std::uint64_t mPendingDataOffset      = 0;  ///< Offset of the first fed byte not yet written to the file.
+        Map<std::uint64_t, std::uint64_t> mFragmentMdatBases;  ///< Base offsets of 'mdat' boxes of fragmented output,
+                                                               ///< keyed by the offset of the first fed byte in them.
+
         bool mOwnsOutputHandle = false;  ///< True if the writer owns the output handle
 
         bool mWriteItemCreationTimes = false;  ///< Create and associate CreationTimeProperty to added image items.
 
+        bool mDeduplicateMediaData = true;   ///< Store media data with identical content only once.
+        bool mCompareMediaData     = false;  ///< Compare content of deduplicated media data byte by byte.
+
         PropertyId mPredRrefPropertyId = 0;  ///< ID of 'pred' Required reference types property. 0 if not created.
     };
 
@@ -179,7 +179,7 @@ namespace HEIF
 
         const MediaData& mediaData = mMediaData.at(aMediaDataId);
 
-        aImageId = Context::getValue();
+        aImageId = mContextIds.getValue();
 
         ImageCollection::Image newImage;
         newImage.imageId                  = aImageId;
@@ -796,7 +796,7 @@ namespace HEIF
         {
             return ErrorCode::INVALID_ITEM_ID;
         }
-        derivedImageId = Context::getValue();
+        derivedImageId = mContextIds.getValue();
         ImageCollection::Image newImage;
         newImage.isHidden                       = false;
         newImage.imageId                        = derivedImageId;
@@ -911,7 +911,7 @@ namespace HEIF
             return ErrorCode::INVALID_FUNCTION_PARAMETER;
         }
 
-        gridId = Context::getValue();
+        gridId = mContextIds.getValue();
         ImageCollection::Image newImage;
         newImage.imageId                = gridId;
         mImageCollection.images[gridId] = newImage;
@@ -962,7 +962,7 @@ namespace HEIF
             return ErrorCode::INVALID_FUNCTION_PARAMETER;
         }
 
-        overlayId = Context::getValue();
+        overlayId = mContextIds.getValue();
         ImageCollection::Image newImage;
         newImage.imageId                   = overlayId;
         mImageCollection.images[overlayId] = newImage;
@@ -1143,7 +1143,7 @@ namespace HEIF
                 {MediaFormat::XMP, {FourCCInt("mime"), "", "application/rdf+xml"}}};
             const FormatNames& format = formatMapping.at(mediaData.mediaFormat);
 
-            mMetadataItems[mediaDataId] = Context::getValue();
+            mMetadataItems[mediaDataId] = mContextIds.getValue();
 
             ItemInfoEntry infe;
             infe.setVersion(2);
@@ -11,6 +11,7 @@
  * written consent of Nokia.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 
@@ -292,6 +293,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::NOT_APPLICABLE;  // Tracks can not be added after 'moov' of fragmented output.
+        }
+
         if (aTimeBase.den == 0 || aTimeBase.num == 0)
         {
             return ErrorCode::INVALID_FUNCTION_PARAMETER;  // timebase / timebase can't be zero
@@ -304,9 +310,9 @@ namespace HEIF
         }
 
         ImageSequence sequence{};
-        sequence.id          = Context::getValue();
+        sequence.id          = mContextIds.getValue();
         aId                  = sequence.id;
-        sequence.trackId     = Track::createTrackId();
+        sequence.trackId     = mTrackIds.createTrackId();
         sequence.handlerType = PICT_HANDLER;
         // sequence.mediaId is filled when first sample is fed to Image Sequence
         sequence.timeBase = aTimeBase;
@@ -381,7 +387,8 @@ namespace HEIF
         }
 
         ImageSequence& sequence = mImageSequences.at(aSequenceId);
-        if (sequence.samples.size() && mMediaData.at(aMediaDataId).mediaFormat != sequence.mediaFormat)
+        if ((sequence.samples.size() || sequence.writtenSampleCount) &&
+            mMediaData.at(aMediaDataId).mediaFormat != sequence.mediaFormat)
         {  // do not allow mediaData from different media formats
             return ErrorCode::INVALID_MEDIA_FORMAT;
         }
@@ -390,6 +397,25 @@ namespace HEIF
             sequence.mediaFormat = mMediaData.at(aMediaDataId).mediaFormat;
         }
 
+        if (mFragmented)
+        {
+            // Start a new fragment at a sync sample, so that each fragment can be decoded on its own.
+            if (aSampleInfo.isSyncSample && aSampleInfo.referenceSamples.size == 0 && isFragmentDue())
+            {
+                ErrorCode error = writeMovieFragment();
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+            }
+            // Sample descriptions can not be added after 'moov' has been written.
+            if (mMoovWritten && std::find(sequence.decoderConfigs.begin(), sequence.decoderConfigs.end(),
+                                          mMediaData.at(aMediaDataId).decoderConfigId) == sequence.decoderConfigs.end())
+            {
+                return ErrorCode::INVALID_DECODER_CONFIG_ID;
+            }
+        }
+
         ImageSequence::Sample sample = {};
         if (sequence.samples.size())
         {
@@ -397,7 +423,7 @@ namespace HEIF
         }
         else
         {
-            sample.sampleIndex = 0;
+            sample.sampleIndex = sequence.writtenSampleCount;
         }
 
         for (const auto& refSample : aSampleInfo.referenceSamples)
@@ -419,10 +445,12 @@ namespace HEIF
         }
 
         sample.mediaDataId     = aMediaDataId;
-        sample.sequenceImageId = Context::getValue();
+        sample.sequenceImageId = mContextIds.getValue();
         aSequenceImageId       = sample.sequenceImageId;
         sample.sampleDuration  = static_cast<uint32_t>(aSampleInfo.duration * sequence.timeBase.num);
-        sample.dts = sequence.samples.size() ? sequence.samples.back().dts + sequence.samples.back().sampleDuration : 0;
+        sample.dts               = sequence.samples.size()
+                                       ? sequence.samples.back().dts + sequence.samples.back().sampleDuration
+                                       : sequence.writtenDuration;
         sample.compositionOffset = aSampleInfo.compositionOffset * static_cast<int64_t>(sequence.timeBase.num);
         sample.isSyncSample      = aSampleInfo.isSyncSample;
 
@@ -538,7 +566,7 @@ namespace HEIF
         // Add tracks to same Alternate Group
         if (imageSequence.alternateGroup.get() == 0)
         {  // create new
-            imageSequence.alternateGroup = Track::createAlternateGroupId();
+            imageSequence.alternateGroup = mTrackIds.createAlternateGroupId();
         }
         thumpSequence.alternateGroup = imageSequence.alternateGroup;
 
@@ -661,7 +689,7 @@ namespace HEIF
         if (sequence1.alternateGroup.get() == 0 && sequence2.alternateGroup.get() == 0)
         {
             // create new
-            sequence1.alternateGroup = Track::createAlternateGroupId();
+            sequence1.alternateGroup = mTrackIds.createAlternateGroupId();
             sequence2.alternateGroup = sequence1.alternateGroup;
         }
         else if (sequence1.alternateGroup.get() == 0 && sequence2.alternateGroup.get() != 0)
@@ -733,7 +761,16 @@ namespace HEIF
             }
 
             // Sample Table writing:
-            if (sequence.samples.size())
+            if (mFragmented)
+            {
+                // Samples go to movie fragments, 'moov' has only the sample descriptions.
+                ErrorCode stsdError = writeMoovSampleDescriptions(sequence);
+                if (stsdError != ErrorCode::OK)
+                {
+                    return stsdError;
+                }
+            }
+            else if (sequence.samples.size())
             {
                 if (sequence.handlerType != SOUN_HANDLER)  // rest are pict/vide specific
                 {
@@ -773,13 +810,17 @@ namespace HEIF
             trackHeaderBox.setWidth(sequence.maxDimensions.width << 16);    // to fixed point 16.16 value
             trackHeaderBox.setHeight(sequence.maxDimensions.height << 16);  // to fixed point 16.16 value
 
-            // Media duration:
-            track->getMediaBox().getMediaHeaderBox().setDuration(sequence.duration);
+            // Media duration, unknown when 'moov' of fragmented output is written:
+            track->getMediaBox().getMediaHeaderBox().setDuration(mFragmented ? 0 : sequence.duration);
 
             // Track duration:
             uint64_t trackDuration;
             // Use track duration from edit list if it has been set.
-            if (track->getEditBox() == nullptr)
+            if (mFragmented)
+            {
+                trackDuration = 0;
+            }
+            else if (track->getEditBox() == nullptr)
             {
                 trackDuration = sequence.duration * movieTimescale / sequence.timeBase.den;
             }
@@ -797,10 +838,26 @@ namespace HEIF
             writeTrackGroups(sequence);
         }
 
+        if (mFragmented)
+        {
+            UniquePtr<MovieExtendsBox> mvex = makeCustomUnique<MovieExtendsBox, MovieExtendsBox>();
+            for (const auto& imageSequence : mImageSequences)
+            {
+                MOVIEFRAGMENTS::SampleDefaults sampleDefaults{};
+                sampleDefaults.trackId                       = imageSequence.second.trackId.get();
+                sampleDefaults.defaultSampleDescriptionIndex = 1;
+
+                UniquePtr<TrackExtendsBox> trex = makeCustomUnique<TrackExtendsBox, TrackExtendsBox>();
+                trex->setFragmentSampleDefaults(sampleDefaults);
+                mvex->addTrackExtendsBox(std::move(trex));
+            }
+            mMovieBox.addMovieExtendsBox(std::move(mvex));
+        }
+
         mMovieBox.getMovieHeaderBox().setTimeScale(movieTimescale);
         mMovieBox.getMovieHeaderBox().setDuration(movieDuration);
         mMovieBox.getMovieHeaderBox().setModificationTime(modificationTime);
-        mMovieBox.getMovieHeaderBox().setNextTrackID(Track::createTrackId().get());
+        mMovieBox.getMovieHeaderBox().setNextTrackID(mTrackIds.createTrackId().get());
         if (mMatrix.size())
         {
             mMovieBox.getMovieHeaderBox().setMatrix(mMatrix);
@@ -916,7 +973,7 @@ namespace HEIF
         return ErrorCode::INVALID_SEQUENCE_IMAGE_ID;
     }
 
-    ErrorCode WriterImpl::updateMoovBox(uint64_t mdatOffset)
+    ErrorCode WriterImpl::updateMoovBox(uint64_t mdatOffset, BitStream& moovOutput)
     {
         for (auto& imageSequence : mImageSequences)
         {
@@ -928,6 +985,7 @@ namespace HEIF
             {
                 offset += mdatOffset;
             }
+            stbl.getChunkOffsetBox().updateSerializedChunkOffsets(moovOutput);
         }
         return ErrorCode::OK;
     }
@@ -1183,41 +1241,49 @@ namespace HEIF
                 stsc.addChunkEntry(chunk);
             }
             // stsd
-            SampleDescriptionBox& stsd = stbl.getSampleDescriptionBox();
-            for (auto& decoderConfig : sequence.decoderConfigs)
+            return writeMoovSampleDescriptions(sequence);
+        }
+        return ErrorCode::OK;
+    }
+
+    ErrorCode WriterImpl::writeMoovSampleDescriptions(ImageSequence& sequence)
+    {
+        TrackBox* track            = mMovieBox.getTrackBox(sequence.trackId.get());
+        SampleDescriptionBox& stsd =
+            track->getMediaBox().getMediaInformationBox().getSampleTableBox().getSampleDescriptionBox();
+        for (auto& decoderConfig : sequence.decoderConfigs)
+        {
+            UniquePtr<SampleEntryBox> sampleEntryBox;
+            if (sequence.mediaFormat == MediaFormat::AVC)
             {
-                UniquePtr<SampleEntryBox> sampleEntryBox;
-                if (sequence.mediaFormat == MediaFormat::AVC)
+                ErrorCode error =
+                    makeAVCVideoSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
+                if (error != ErrorCode::OK)
                 {
-                    ErrorCode error =
-                        makeAVCVideoSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
-                    if (error != ErrorCode::OK)
-                    {
-                        return error;
-                    }
-
-                    stsd.addSampleEntry(std::move(sampleEntryBox));
+                    return error;
                 }
-                else if (sequence.mediaFormat == MediaFormat::HEVC)
+
+                stsd.addSampleEntry(std::move(sampleEntryBox));
+            }
+            else if (sequence.mediaFormat == MediaFormat::HEVC)
+            {
+                ErrorCode error =
+                    makeHEVCVideoSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
+                if (error != ErrorCode::OK)
                 {
-                    ErrorCode error =
-                        makeHEVCVideoSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
-                    if (error != ErrorCode::OK)
-                    {
-                        return error;
-                    }
-                    stsd.addSampleEntry(std::move(sampleEntryBox));
+                    return error;
                 }
-                else if (sequence.mediaFormat == MediaFormat::AAC)
+                stsd.addSampleEntry(std::move(sampleEntryBox));
+            }
+            else if (sequence.mediaFormat == MediaFormat::AAC)
+            {
+                ErrorCode error =
+                    makeMP4AudioSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
+                if (error != ErrorCode::OK)
                 {
-                    ErrorCode error =
-                        makeMP4AudioSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
-                    if (error != ErrorCode::OK)
-                    {
-                        return error;
-                    }
-                    stsd.addSampleEntry(std::move(sampleEntryBox));
+                    return error;
                 }
+                stsd.addSampleEntry(std::move(sampleEntryBox));
             }
         }
         return ErrorCode::OK;
@@ -1618,6 +1684,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::NOT_APPLICABLE;  // Tracks can not be added after 'moov' of fragmented output.
+        }
+
         if (aTimeBase.den == 0 || aTimeBase.num == 0)
         {
             return ErrorCode::INVALID_FUNCTION_PARAMETER;  // timebase / timebase can't be zero
@@ -1630,9 +1701,9 @@ namespace HEIF
         }
 
         ImageSequence sequence{};
-        sequence.id          = Context::getValue();
+        sequence.id          = mContextIds.getValue();
         aId                  = sequence.id;
-        sequence.trackId     = Track::createTrackId();
+        sequence.trackId     = mTrackIds.createTrackId();
         sequence.handlerType = VIDE_HANDLER;
         // sequence.mediaId is filled when first sample is fed to Image Sequence
         sequence.timeBase = aTimeBase;
@@ -1689,6 +1760,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::NOT_APPLICABLE;  // Tracks can not be added after 'moov' of fragmented output.
+        }
+
         if (aTimeBase.den == 0 || aTimeBase.num == 0)
         {
             return ErrorCode::INVALID_FUNCTION_PARAMETER;  // timebase / timebase can't be zero
@@ -1701,9 +1777,9 @@ namespace HEIF
         }
 
         ImageSequence sequence{};
-        sequence.id          = Context::getValue();
+        sequence.id          = mContextIds.getValue();
         aId                  = sequence.id;
-        sequence.trackId     = Track::createTrackId();
+        sequence.trackId     = mTrackIds.createTrackId();
         sequence.handlerType = SOUN_HANDLER;
         // sequence.mediaId is filled when first sample is fed to Image Sequence
         sequence.timeBase = aTimeBase;